@@ -0,0 +1,113 @@
+// Asignadores de nodos para las estructuras enlazadas (arboles, listas).
+// Las clases que los usan reciben el asignador como parametro de plantilla:
+//     template <template <class> class Asignador = AsignadorNew> class ItvTree { Asignador<ItvTreeNode> asignador; ... };
+// y piden los nodos con asignador.crear(args...) / asignador.destruir(nodo).
+//
+//   - AsignadorNew: lo de siempre, un new/delete por nodo.
+//   - ArenaNodos: los nodos salen seguidos de bloques grandes (slabs). Los que se destruyen sueltos van a una
+//     lista de libres y se reutilizan. liberarTodo() olvida todos los nodos de golpe en O(1) (los slabs se
+//     quedan reservados para reutilizarlos), asi que vaciar una estructura no es recorrerla nodo a nodo.
+//
+// Uso: #include "../Comun/Arena.h"
+
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <cstddef>
+#include <type_traits>
+
+template <class Nodo>
+class AsignadorNew
+{
+public:
+    static const bool liberaEnBloque = false; // liberarTodo() no libera nada: hay que destruir nodo a nodo
+
+    template <class... Args>
+    Nodo *crear(Args &&...args)
+    {
+        return new Nodo(std::forward<Args>(args)...);
+    }
+
+    void destruir(Nodo *n)
+    {
+        delete n;
+    }
+
+    void liberarTodo() {}
+};
+
+template <class Nodo>
+class ArenaNodos
+{
+private:
+    static_assert(std::is_trivially_destructible<Nodo>::value, "liberarTodo() no llama a los destructores");
+    static_assert(sizeof(Nodo) >= sizeof(void *), "un nodo libre guarda dentro el puntero al siguiente libre");
+
+    static const size_t NODOS_POR_SLAB = 1 << 16;
+
+    std::vector<void *> slabs;
+    size_t slabActual = 0;               // Slab del que se estan sacando nodos
+    size_t usados = NODOS_POR_SLAB;      // Nodos ya dados del slab actual (lleno = hay que pasar al siguiente)
+    void *libres = nullptr;              // Lista de nodos destruidos sueltos, para reutilizarlos
+
+    void *siguienteHueco()
+    {
+        if (libres)
+        {
+            void *hueco = libres;
+            libres = *(void **)hueco;
+            return hueco;
+        }
+        if (usados == NODOS_POR_SLAB)
+        {
+            if (slabs.empty() || slabActual + 1 >= slabs.size())
+            {
+                slabs.push_back(::operator new(sizeof(Nodo) * NODOS_POR_SLAB));
+                slabActual = slabs.size() - 1;
+            }
+            else
+            {
+                slabActual++; // Slab que ya teniamos de antes de un liberarTodo()
+            }
+            usados = 0;
+        }
+        return (char *)slabs[slabActual] + sizeof(Nodo) * usados++;
+    }
+
+public:
+    static const bool liberaEnBloque = true;
+
+    ArenaNodos() = default;
+    ArenaNodos(const ArenaNodos &) = delete;
+    ArenaNodos &operator=(const ArenaNodos &) = delete;
+
+    ~ArenaNodos()
+    {
+        for (void *s : slabs)
+            ::operator delete(s);
+    }
+
+    template <class... Args>
+    Nodo *crear(Args &&...args)
+    {
+        return new (siguienteHueco()) Nodo(std::forward<Args>(args)...);
+    }
+
+    void destruir(Nodo *n)
+    {
+        *(void **)n = libres;
+        libres = n;
+    }
+
+    void liberarTodo() // O(1): todos los nodos dados dejan de ser validos
+    {
+        slabActual = 0;
+        usados = slabs.empty() ? NODOS_POR_SLAB : 0;
+        libres = nullptr;
+    }
+};
+
+#endif
@@ -0,0 +1,215 @@
+// Entero sin signo con aritmetica comprobada, para sumas y productos que normalmente caben en 64 bits
+// pero que con entradas raras (columnas muy largas de '*') se desbordarian sin avisar.
+// Se guarda en el nivel mas barato que lo puede representar y solo sube cuando hace falta:
+//   - N64:    uint64_t. Cada operacion es la normal mas un __builtin_*_overflow.
+//   - N128:   unsigned __int128, si el resultado de 64 bits se ha desbordado.
+//   - GRANDE: vector de "limbs" de 32 bits (little-endian) si tampoco cabe en 128 bits.
+// Nunca se baja de nivel: una vez se ha desbordado, lo normal es que siga creciendo.
+//
+// Uso: #include "../Comun/Entero.h"
+//      Entero total; total += Entero(x); total *= otro; num.agregarDigito(d); cout << total;
+
+#ifndef ENTERO_H
+#define ENTERO_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <algorithm>
+
+class Entero
+{
+public:
+    enum Nivel : uint8_t
+    {
+        N64,
+        N128,
+        GRANDE
+    };
+
+private:
+    typedef unsigned __int128 u128;
+
+    Nivel nivel = N64;
+    uint64_t v64 = 0;
+    u128 v128 = 0;
+    std::vector<uint32_t> limbs; // Solo en GRANDE; sin ceros de sobra al final
+
+    u128 como128() const { return (nivel == N64) ? (u128)v64 : v128; }
+
+    std::vector<uint32_t> comoLimbs() const
+    {
+        if (nivel == GRANDE)
+            return limbs;
+        std::vector<uint32_t> l;
+        for (u128 x = como128(); x != 0; x >>= 32)
+            l.push_back((uint32_t)x);
+        return l;
+    }
+
+    void poner128(u128 x)
+    {
+        nivel = N128;
+        v128 = x;
+    }
+
+    void ponerGrande(std::vector<uint32_t> l)
+    {
+        while (!l.empty() && l.back() == 0)
+            l.pop_back();
+        nivel = GRANDE;
+        limbs = std::move(l);
+    }
+
+    static std::vector<uint32_t> sumarLimbs(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+    {
+        std::vector<uint32_t> r(std::max(a.size(), b.size()) + 1, 0);
+        uint64_t acarreo = 0;
+        for (size_t i = 0; i + 1 < r.size(); i++)
+        {
+            uint64_t s = acarreo + (i < a.size() ? a[i] : 0) + (i < b.size() ? b[i] : 0);
+            r[i] = (uint32_t)s;
+            acarreo = s >> 32;
+        }
+        r.back() = (uint32_t)acarreo;
+        return r;
+    }
+
+    static std::vector<uint32_t> multiplicarLimbs(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b)
+    {
+        std::vector<uint32_t> r(a.size() + b.size(), 0);
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            uint64_t acarreo = 0;
+            for (size_t j = 0; j < b.size(); j++)
+            {
+                uint64_t t = (uint64_t)a[i] * b[j] + r[i + j] + acarreo;
+                r[i + j] = (uint32_t)t;
+                acarreo = t >> 32;
+            }
+            r[i + b.size()] = (uint32_t)acarreo;
+        }
+        return r;
+    }
+
+    static std::string decimal128(u128 x)
+    {
+        if (x == 0)
+            return "0";
+        std::string s;
+        while (x != 0)
+        {
+            s.push_back('0' + (int)(x % 10));
+            x /= 10;
+        }
+        std::reverse(s.begin(), s.end());
+        return s;
+    }
+
+public:
+    Entero(uint64_t x = 0) : v64(x) {}
+
+    Nivel nivelActual() const { return nivel; }
+
+    Entero &operator+=(const Entero &o)
+    {
+        if (nivel == N64 && o.nivel == N64)
+        {
+            uint64_t r;
+            if (!__builtin_add_overflow(v64, o.v64, &r))
+            {
+                v64 = r;
+                return *this;
+            }
+        }
+        if (nivel != GRANDE && o.nivel != GRANDE)
+        {
+            u128 r;
+            if (!__builtin_add_overflow(como128(), o.como128(), &r))
+            {
+                poner128(r);
+                return *this;
+            }
+        }
+        ponerGrande(sumarLimbs(comoLimbs(), o.comoLimbs()));
+        return *this;
+    }
+
+    Entero &operator*=(const Entero &o)
+    {
+        if (nivel == N64 && o.nivel == N64)
+        {
+            uint64_t r;
+            if (!__builtin_mul_overflow(v64, o.v64, &r))
+            {
+                v64 = r;
+                return *this;
+            }
+        }
+        if (nivel != GRANDE && o.nivel != GRANDE)
+        {
+            u128 r;
+            if (!__builtin_mul_overflow(como128(), o.como128(), &r))
+            {
+                poner128(r);
+                return *this;
+            }
+        }
+        ponerGrande(multiplicarLimbs(comoLimbs(), o.comoLimbs()));
+        return *this;
+    }
+
+    void agregarDigito(unsigned d) // *this = *this * 10 + d, para ir leyendo un numero cifra a cifra
+    {
+        if (nivel == N64)
+        {
+            uint64_t r;
+            if (!__builtin_mul_overflow(v64, (uint64_t)10, &r) && !__builtin_add_overflow(r, (uint64_t)d, &r))
+            {
+                v64 = r;
+                return;
+            }
+        }
+        *this *= Entero(10);
+        *this += Entero(d);
+    }
+
+    std::string str() const
+    {
+        if (nivel != GRANDE)
+            return decimal128(como128());
+        // Se divide por 10^9 una y otra vez; cada resto son 9 cifras
+        std::vector<uint32_t> l = limbs;
+        std::vector<uint32_t> trozos;
+        while (!l.empty())
+        {
+            uint64_t resto = 0;
+            for (size_t i = l.size(); i-- > 0;)
+            {
+                uint64_t actual = (resto << 32) | l[i];
+                l[i] = (uint32_t)(actual / 1000000000);
+                resto = actual % 1000000000;
+            }
+            trozos.push_back((uint32_t)resto);
+            while (!l.empty() && l.back() == 0)
+                l.pop_back();
+        }
+        if (trozos.empty())
+            return "0";
+        std::string s = std::to_string(trozos.back());
+        for (size_t i = trozos.size() - 1; i-- > 0;)
+        {
+            std::string t = std::to_string(trozos[i]);
+            s += std::string(9 - t.size(), '0') + t;
+        }
+        return s;
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const Entero &e)
+    {
+        return os << e.str();
+    }
+};
+
+#endif
@@ -0,0 +1,187 @@
+// Cargador de rejillas (mapas de caracteres) compartido por los dias que leen una matriz del input.
+// En lugar de hacer getline + push_back (un string por fila en el heap, y a veces otra copia a
+// vector<vector<char>>), se mapea el fichero entero con mmap y se ve como una matriz 2D:
+//   - Si todas las filas miden lo mismo y no se pide borde, no se copia nada: se lee del propio mapa
+//     saltando 'paso' bytes por fila (la fila mas su salto de linea).
+//   - Si las filas son de distinto tamaño o se pide un borde de relleno, se copia UNA vez a un buffer
+//     contiguo ya rellenado, para que at(r, c) siga siendo una multiplicacion y una suma.
+// El mapa es MAP_PRIVATE con escritura, asi que se puede modificar la rejilla en memoria (copy-on-write)
+// sin tocar el fichero.
+//
+// Uso: #include "../Comun/Rejilla.h"
+//      Rejilla g;
+//      if (!g.abrir("input.txt")) ...
+//      g.filas(), g.columnas(), g.at(r, c), g.fila(r)
+
+#ifndef REJILLA_H
+#define REJILLA_H
+
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+class Rejilla
+{
+private:
+    char *mapa = nullptr;
+    size_t tamMapa = 0;
+    std::vector<char> copia; // Solo se usa si hay que rellenar
+    char *datos = nullptr;   // Donde empieza la casilla (0, 0)
+    int nFilas = 0;
+    int nColumnas = 0;
+    int paso = 0;  // Bytes entre el comienzo de una fila y el de la siguiente
+    int borde = 0; // Casillas de relleno alrededor: se puede acceder a [-borde, filas + borde)
+
+    void liberar()
+    {
+        if (mapa)
+            munmap(mapa, tamMapa);
+        mapa = nullptr;
+        tamMapa = 0;
+        copia.clear();
+        datos = nullptr;
+        nFilas = nColumnas = paso = borde = 0;
+    }
+
+    static size_t finDeLinea(const char *p, size_t inicio, size_t tam) // Posicion del '\n' (o tam si es la ultima)
+    {
+        const char *nl = (const char *)memchr(p + inicio, '\n', tam - inicio);
+        return nl ? (size_t)(nl - p) : tam;
+    }
+
+    static size_t longitudSinCR(const char *p, size_t inicio, size_t fin)
+    {
+        return (fin > inicio && p[fin - 1] == '\r') ? fin - inicio - 1 : fin - inicio;
+    }
+
+    // Comprueba si todas las filas miden lo mismo; si es asi deja nFilas, nColumnas y paso
+    bool filasUniformes(const char *p, size_t tam)
+    {
+        size_t primera = finDeLinea(p, 0, tam);
+        size_t cols = longitudSinCR(p, 0, primera);
+        size_t salto = (primera < tam) ? primera + 1 : tam; // Bytes de la primera fila con su fin de linea
+        size_t terminador = salto - cols;                   // 0, 1 ('\n') o 2 ("\r\n")
+        if (salto == 0)
+            return false;
+
+        size_t filas = 0;
+        size_t inicio = 0;
+        while (inicio < tam)
+        {
+            if (inicio + cols > tam)
+                return false;
+            size_t fin = inicio + cols; // Aqui tiene que acabar la fila
+            if (memchr(p + inicio, '\n', cols) != nullptr) // Una fila mas corta que la primera
+                return false;
+            if (fin == tam) // Ultima fila sin salto de linea
+            {
+                filas++;
+                break;
+            }
+            bool saltoBien = (terminador == 1) ? p[fin] == '\n'
+                                               : (terminador == 2 && fin + 1 < tam && p[fin] == '\r' && p[fin + 1] == '\n');
+            if (!saltoBien)
+                return false;
+            filas++;
+            inicio += salto;
+        }
+        nFilas = filas;
+        nColumnas = cols;
+        paso = salto;
+        return true;
+    }
+
+    void copiarConRelleno(const char *p, size_t tam, char relleno)
+    {
+        // Primera pasada: contar filas y la mas ancha
+        std::vector<std::pair<size_t, size_t>> lineas; // (inicio, longitud)
+        size_t inicio = 0;
+        while (inicio < tam)
+        {
+            size_t fin = finDeLinea(p, inicio, tam);
+            lineas.push_back({inicio, longitudSinCR(p, inicio, fin)});
+            inicio = fin + 1;
+        }
+        nFilas = lineas.size();
+        nColumnas = 0;
+        for (auto &l : lineas)
+            nColumnas = std::max(nColumnas, (int)l.second);
+
+        paso = nColumnas + 2 * borde;
+        copia.assign((size_t)(nFilas + 2 * borde) * paso, relleno);
+        datos = copia.data() + (size_t)borde * paso + borde;
+        for (int r = 0; r < nFilas; r++)
+            memcpy(datos + (size_t)r * paso, p + lineas[r].first, lineas[r].second);
+    }
+
+public:
+    Rejilla() = default;
+    ~Rejilla() { liberar(); }
+    Rejilla(const Rejilla &) = delete;
+    Rejilla &operator=(const Rejilla &) = delete;
+
+    // Abre y mapea el fichero. Con bordeRelleno > 0 se añaden casillas 'relleno' alrededor de la rejilla,
+    // y las filas mas cortas que la mas ancha tambien se completan con 'relleno'.
+    bool abrir(const char *ruta, int bordeRelleno = 0, char relleno = '.')
+    {
+        liberar();
+        int fd = open(ruta, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0)
+        {
+            close(fd);
+            return false;
+        }
+        borde = bordeRelleno;
+        if (st.st_size == 0)
+        {
+            close(fd);
+            return true; // Rejilla vacia
+        }
+        tamMapa = st.st_size;
+        void *m = mmap(nullptr, tamMapa, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd); // El mapa sigue vivo aunque se cierre el descriptor
+        if (m == MAP_FAILED)
+        {
+            mapa = nullptr;
+            return false;
+        }
+        mapa = (char *)m;
+        madvise(mapa, tamMapa, MADV_SEQUENTIAL);
+
+        if (borde == 0 && filasUniformes(mapa, tamMapa))
+        {
+            datos = mapa; // Sin copia
+            return true;
+        }
+        copiarConRelleno(mapa, tamMapa, relleno);
+        munmap(mapa, tamMapa); // Ya esta todo en la copia
+        mapa = nullptr;
+        tamMapa = 0;
+        return true;
+    }
+
+    int filas() const { return nFilas; }
+    int columnas() const { return nColumnas; }
+    int bordeRelleno() const { return borde; }
+    bool esCopia() const { return !copia.empty(); }
+
+    // r y c pueden ir de -borde a filas/columnas + borde - 1
+    char at(int r, int c) const { return datos[(std::ptrdiff_t)r * paso + c]; }
+    char &at(int r, int c) { return datos[(std::ptrdiff_t)r * paso + c]; }
+
+    std::string_view fila(int r) const { return std::string_view(datos + (std::ptrdiff_t)r * paso, nColumnas); }
+    const char *filaPtr(int r) const { return datos + (std::ptrdiff_t)r * paso; }
+    char *filaPtr(int r) { return datos + (std::ptrdiff_t)r * paso; }
+    int pasoFila() const { return paso; }
+};
+
+#endif
@@ -1,17 +1,122 @@
+// compilar: g++ -std=c++17 -O2 -pthread -o part1 part1.cpp
+// en paralel: ./part1 --threads N
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <sstream>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstring>
 
 #define ull unsigned long long
+#define GRANO 65536 // rangs mes grans que aso es partixen
 
 using namespace std;
 
+ull sumaRango(ull desde, ull hasta)
+{
+    ull count = 0;
+    for (ull i = desde; i <= hasta; i++)
+    {
+        string aell = to_string(i);
+        // los numeros con digitos impares no pueden tener digitos repetidos dos veces
+        if ((aell.size()) % 2 == 0) // si el nº de digitos es par
+        {
+            int mid = (aell.size())/ 2;
+            if (aell.substr(0,mid) == aell.substr(mid))
+            {
+                count += i;
+            }
+        }
+        if (i == hasta) break; // pa que no se quede en bucle si hasta es el maxim de ull
+    }
+    return count;
+}
+
+// cada fil te la seua cua, si agafa un rang massa gran el partix per la mitat i deixa una meitat
+// en la cua pa que li la puga robar un altre fil que estiga parat. cada fil suma en el seu parcial
+// i al final es sumen en ordre, aixi sempre ix lo mateix
+struct Cola
+{
+    mutex m;
+    deque<pair<ull, ull>> tareas;
+};
+
+class PoolRobo
+{
+private:
+    vector<Cola> colas;
+    vector<ull> parciales;
+    atomic<long long> pendientes{0};
+
+    void empujar(int id, pair<ull, ull> t){
+        pendientes++;
+        lock_guard<mutex> lock(colas[id].m);
+        colas[id].tareas.push_back(t);
+    }
+    bool sacar(int id, pair<ull, ull> &t){ // el propi fil trau per darrere
+        lock_guard<mutex> lock(colas[id].m);
+        if (colas[id].tareas.empty()) {return false;}
+        t = colas[id].tareas.back();
+        colas[id].tareas.pop_back();
+        return true;
+    }
+    bool robar(int id, pair<ull, ull> &t){ // els altres roben per davant, on estan els trossos grans
+        for (int k = 1; k < (int)colas.size(); k++)
+        {
+            Cola &victima = colas[(id + k) % colas.size()];
+            lock_guard<mutex> lock(victima.m);
+            if (!victima.tareas.empty()) {
+                t = victima.tareas.front();
+                victima.tareas.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+    void trabajar(int id){
+        pair<ull, ull> t;
+        while (pendientes > 0)
+        {
+            if (!sacar(id, t) && !robar(id, t)) {this_thread::yield(); continue;}
+            while (t.second - t.first >= GRANO) // partir per la mitat
+            {
+                ull mitat = t.first + (t.second - t.first) / 2;
+                empujar(id, {mitat + 1, t.second});
+                t.second = mitat;
+            }
+            parciales[id] += sumaRango(t.first, t.second);
+            pendientes--;
+        }
+    }
+public:
+    PoolRobo(int hilos) : colas(hilos), parciales(hilos, 0) {}
+
+    ull ejecutar(vector<pair<ull, ull>> &rangos){
+        for (int i = 0; i < (int)rangos.size(); i++) {empujar(i % colas.size(), rangos[i]);}
+
+        vector<thread> hilos;
+        for (int id = 0; id < (int)colas.size(); id++) {hilos.emplace_back(&PoolRobo::trabajar, this, id);}
+        for (thread &h : hilos) {h.join();}
+
+        ull total = 0;
+        for (ull p : parciales) {total += p;}
+        return total;
+    }
+};
+
 int main(int argc, char const *argv[])
 {
+    int hilos = 1;
+    if (argc == 3 && strcmp(argv[1], "--threads") == 0) {hilos = max(1, atoi(argv[2]));}
+
     ifstream fich("input.txt");
     string l1;
     ull count = 0;
+    vector<pair<ull, ull>> rangos;
 
     while (getline(fich, l1))
     {
@@ -22,21 +127,17 @@ int main(int argc, char const *argv[])
             int pos_guion = aux.find('-');
             ull desde = stoull(aux.substr(0,pos_guion));
             ull hasta = stoull(aux.substr(pos_guion + 1));
-            for (ull i = desde; i <= hasta; i++)
-            {
-                string aell = to_string(i);
-                // los numeros con digitos impares no pueden tener digitos repetidos dos veces
-                if ((aell.size()) % 2 == 0) // si el nº de digitos es par
-                {
-                    int mid = (aell.size())/ 2;
-                    if (aell.substr(0,mid) == aell.substr(mid))
-                    {
-                        count += i;
-                    }
-                }
-            }
+            if (desde > hasta) {continue;}
+
+            if (hilos == 1) {count += sumaRango(desde, hasta);}
+            else {rangos.push_back({desde, hasta});}
         }
     }
+    if (hilos > 1)
+    {
+        PoolRobo pool(hilos);
+        count = pool.ejecutar(rangos);
+    }
     cout << count << endl;
     fich.close();
 
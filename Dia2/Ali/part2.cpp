@@ -2,13 +2,49 @@
 #include <fstream>
 #include <string>
 #include <sstream>
-#include <vector>
 #include <algorithm>
 
 #define ull unsigned long long
 
 using namespace std;
 
+typedef unsigned __int128 u128;
+
+// en compte de mirar tots els numeros del rang, generem directament els que son un patro repetit:
+// un numero de n digits fet amb un patro de j digits es patro * R, amb R = 1 + 10^j + 10^2j + ...
+u128 pot10(int e) { u128 r = 1; while (e-- > 0) r *= 10; return r; }
+
+u128 sumaPatro(int n, int j, ull desde, ull hasta) // suma de patro*R dins de [desde, hasta]
+{
+    u128 R = 0;
+    for (int k = 0; k < n/j; k++) { R = R * pot10(j) + 1; }
+
+    u128 primer = max(pot10(j - 1), ((u128)desde + R - 1) / R); // el patro no pot començar en 0
+    u128 ultim = min(pot10(j) - 1, (u128)hasta / R);
+    if (primer > ultim) { return 0; }
+    return R * ((primer + ultim) * (ultim - primer + 1) / 2);
+}
+
+ull sumaRepetidos(ull desde, ull hasta)
+{
+    u128 total = 0;
+    int dDesde = to_string(desde).size(), dHasta = to_string(hasta).size();
+    for (int n = dDesde; n <= dHasta; n++) // nº de digits
+    {
+        u128 exacte[21] = {0}; // suma dels que tenen com a patro minim j digits (pa no contar 2 voltes 1111 amb j=1 i j=2)
+        for (int j = 1; j <= n/2; j++) // pa fer patrons en divisors
+        {
+            if (n % j == 0) // si es divisor
+            {
+                exacte[j] = sumaPatro(n, j, desde, hasta);
+                for (int k = 1; k < j; k++) { if (j % k == 0) exacte[j] -= exacte[k]; }
+                total += exacte[j];
+            }
+        }
+    }
+    return (ull)total;
+}
+
 int main(int argc, char const *argv[])
 {
     ifstream fich("input.txt");
@@ -25,27 +61,7 @@ int main(int argc, char const *argv[])
             ull desde = stoull(aux.substr(0,pos_guion));
             ull hasta = stoull(aux.substr(pos_guion + 1));
 
-            for (ull i = desde; i <= hasta; i++)
-            {
-                string num = to_string(i); // convertir a string
-                int digitos = num.size(); // tamaño del numero
-                
-                for (int j = 1; j <= digitos/2; j++) // pa fer substrigs en divisores
-                {
-                    if (num.size() % j == 0) // si es divisor
-                    {
-                        string patron = num.substr(0, j);
-                        string reconstruido = "";
-                        for (int k = 0; k < digitos/j; k++) { reconstruido += patron; }
-                        if (reconstruido == num) 
-                        { 
-                            count += i; 
-                            break; // per a que no faja el for j = 1
-                        }
-                        
-                    }
-                }    
-            }
+            count += sumaRepetidos(desde, hasta);
         }
     }
     cout << count << endl;
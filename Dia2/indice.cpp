@@ -0,0 +1,266 @@
+// Index precalculat dels IDs invalids, per a quan el mateix binari ha de contestar molts rangs.
+// Es generen una sola volta tots els numeros que son un bloc repetit (fins a 10^digits), ordenats,
+// amb dos columnes de sumes prefixes:
+//   - exacto2:  el bloc repetit exactament dos voltes (la regla de parte1.cpp)
+//   - almenos2: el bloc repetit dos o mes voltes (la regla de parte2.cpp)
+// Cada consulta a-b son dos cerques binaries, O(log n).
+//
+// Ull: fins a 10^18 n'hi ha prop de 10^9 (sobretot els de bloc de 9 digits repetit 2 voltes), aixina
+// que per defecte l'index arriba a 12 digits (~1.1 milions de numeros) i com a molt a 14.
+//
+// Compilar: g++ -std=c++17 -O2 -o indice indice.cpp
+// Construir: ./indice construir [digits] [fitxer]   (per defecte 12 i ids.idx)
+// Consultar: ./indice [fitxer]                      (llig els rangs de input.txt)
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+typedef unsigned long long ull;
+typedef unsigned __int128 u128;
+
+using namespace std;
+
+const int MAX_DIGITOS = 14;
+
+// Format en disc (little-endian, com la maquina):
+//   Cabecera (32 bytes)
+//   ull  valores[n]          ordenats i sense repetits
+//   (farciment fins a multiple de 16)
+//   u128 exacto2[n + 1]      exacto2[i] = suma dels i primers valors que complixen la regla de parte1
+//   u128 almenos2[n + 1]     almenos2[i] = suma dels i primers valors (tots complixen la de parte2)
+struct Cabecera
+{
+    char magia[8];   // "AOC2IDX"
+    uint32_t version;
+    uint32_t digitos; // L'index cobrix [1, 10^digitos)
+    uint64_t n;
+    uint64_t reservado;
+};
+
+const char MAGIA[8] = "AOC2IDX";
+const uint32_t VERSION = 1;
+
+size_t alinear16(size_t x)
+{
+    return (x + 15) & ~(size_t)15;
+}
+
+ull potencia10(int e)
+{
+    ull r = 1;
+    for (int i = 0; i < e; i++)
+        r *= 10;
+    return r;
+}
+
+int construir(int digitos, const char *ruta)
+{
+    vector<ull> valores;
+    vector<char> exacto;
+
+    for (int n = 2; n <= digitos; n++) // Els de n digits son tots mes grans que els de n-1, aixina que ja ixen ordenats per longitud
+    {
+        vector<pair<ull, char>> longitud; // (valor, complix la regla de parte1)
+        for (int p = 1; p < n; p++)
+        {
+            if (n % p != 0)
+                continue;
+            ull R = 0;
+            for (int i = 0; i < n / p; i++)
+                R = R * potencia10(p) + 1;
+            for (ull bloque = potencia10(p - 1); bloque < potencia10(p); bloque++)
+                longitud.push_back({bloque * R, (char)(2 * p == n)});
+        }
+        sort(longitud.begin(), longitud.end());
+        for (size_t i = 0; i < longitud.size(); i++)
+        {
+            if (!valores.empty() && valores.back() == longitud[i].first) // 1111 ix amb p=1 i amb p=2
+            {
+                exacto.back() |= longitud[i].second;
+                continue;
+            }
+            valores.push_back(longitud[i].first);
+            exacto.push_back(longitud[i].second);
+        }
+    }
+
+    size_t n = valores.size();
+    vector<u128> exacto2(n + 1, 0), almenos2(n + 1, 0);
+    for (size_t i = 0; i < n; i++)
+    {
+        exacto2[i + 1] = exacto2[i] + (exacto[i] ? valores[i] : 0);
+        almenos2[i + 1] = almenos2[i] + valores[i];
+    }
+
+    Cabecera cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, MAGIA, sizeof(MAGIA));
+    cab.version = VERSION;
+    cab.digitos = digitos;
+    cab.n = n;
+
+    ofstream salida(ruta, ios::binary);
+    if (!salida.is_open())
+    {
+        cerr << "No se pudo crear " << ruta << endl;
+        return 1;
+    }
+    salida.write((const char *)&cab, sizeof(cab));
+    salida.write((const char *)valores.data(), n * sizeof(ull));
+    size_t relleno = alinear16(sizeof(cab) + n * sizeof(ull)) - (sizeof(cab) + n * sizeof(ull));
+    const char ceros[16] = {0};
+    salida.write(ceros, relleno);
+    salida.write((const char *)exacto2.data(), (n + 1) * sizeof(u128));
+    salida.write((const char *)almenos2.data(), (n + 1) * sizeof(u128));
+    if (!salida)
+    {
+        cerr << "Error escribiendo " << ruta << endl;
+        return 1;
+    }
+    cout << "Indice de " << n << " numeros hasta 10^" << digitos << " escrito en " << ruta << endl;
+    return 0;
+}
+
+class Indice // Es mapeja el fitxer i es consulta directament, sense copiar res
+{
+private:
+    int fd = -1;
+    void *mapa = nullptr;
+    size_t tam = 0;
+    const Cabecera *cab = nullptr;
+    const ull *valores = nullptr;
+    const u128 *exacto2 = nullptr;
+    const u128 *almenos2 = nullptr;
+
+public:
+    ~Indice()
+    {
+        if (mapa)
+            munmap(mapa, tam);
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool abrir(const char *ruta)
+    {
+        fd = open(ruta, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Cabecera))
+            return false;
+        tam = st.st_size;
+        mapa = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED)
+        {
+            mapa = nullptr;
+            return false;
+        }
+
+        cab = (const Cabecera *)mapa;
+        if (memcmp(cab->magia, MAGIA, sizeof(MAGIA)) != 0 || cab->version != VERSION)
+            return false;
+        size_t n = cab->n;
+        size_t ini_prefijos = alinear16(sizeof(Cabecera) + n * sizeof(ull));
+        if (tam != ini_prefijos + 2 * (n + 1) * sizeof(u128)) // Fitxer truncat o d'un altre format
+            return false;
+
+        const char *base = (const char *)mapa;
+        valores = (const ull *)(base + sizeof(Cabecera));
+        exacto2 = (const u128 *)(base + ini_prefijos);
+        almenos2 = exacto2 + (n + 1);
+        return true;
+    }
+
+    ull limite() const // Primer numero que ja no cobrix l'index
+    {
+        return potencia10(cab->digitos);
+    }
+
+    // Suma dels IDs invalids en [a, b]. parte1 = exactament dos voltes, parte2 = dos o mes.
+    void consultar(ull a, ull b, u128 &parte1, u128 &parte2) const
+    {
+        parte1 = parte2 = 0;
+        if (a > b)
+            return;
+        size_t i = lower_bound(valores, valores + cab->n, a) - valores;
+        size_t j = upper_bound(valores, valores + cab->n, b) - valores;
+        parte1 = exacto2[j] - exacto2[i];
+        parte2 = almenos2[j] - almenos2[i];
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "construir") == 0)
+    {
+        int digitos = (argc >= 3) ? atoi(argv[2]) : 12;
+        const char *ruta = (argc >= 4) ? argv[3] : "ids.idx";
+        if (digitos < 2 || digitos > MAX_DIGITOS)
+        {
+            cerr << "Los digitos tienen que estar entre 2 y " << MAX_DIGITOS << endl;
+            return 1;
+        }
+        return construir(digitos, ruta);
+    }
+
+    const char *ruta = (argc >= 2) ? argv[1] : "ids.idx";
+    Indice indice;
+    if (!indice.abrir(ruta))
+    {
+        cerr << "No se pudo cargar el indice " << ruta << " (construyelo con: " << argv[0] << " construir)" << endl;
+        return 1;
+    }
+
+    ifstream file("input.txt");
+    if (!file.is_open())
+    {
+        cerr << "No se pudo abrir el archivo" << endl;
+        return 1;
+    }
+    string contenido((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+
+    u128 total1 = 0, total2 = 0;
+    const char *p = contenido.data();
+    const char *fin = p + contenido.size();
+    while (p < fin)
+    {
+        ull a, b;
+        auto r1 = from_chars(p, fin, a);
+        if (r1.ec != errc() || r1.ptr == fin || *r1.ptr != '-')
+        {
+            p = (r1.ec == errc()) ? r1.ptr + 1 : p + 1; // Qualsevol cosa que no siga un rang es bota
+            continue;
+        }
+        auto r2 = from_chars(r1.ptr + 1, fin, b);
+        if (r2.ec != errc())
+        {
+            p = r1.ptr + 1;
+            continue;
+        }
+        p = r2.ptr;
+        if (b >= indice.limite())
+        {
+            cerr << "Rango " << a << "-" << b << " fuera del indice, reconstruyelo con mas digitos" << endl;
+            continue;
+        }
+        u128 s1, s2;
+        indice.consultar(a, b, s1, s2);
+        total1 += s1;
+        total2 += s2;
+    }
+
+    cout << "Parte 1: " << (ull)total1 << endl;
+    cout << "Parte 2: " << (ull)total2 << endl;
+    return 0;
+}
@@ -1,96 +1,462 @@
+// Compilar amb: g++ -std=c++17 -O2 -pthread -o parte2 parte2.cpp
+// Execucio paralela: ./parte2 --threads N
 #include <iostream>
 #include <string>
-#include <sstream>
-#include <fstream>
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 using namespace std;
 
-void espacios(string &s)
+typedef unsigned long long ull;
+typedef unsigned __int128 u128; // Per a que les sumes intermitges no desborden
+
+// En conter de recorrer tot el rang numero a numero, contem els numeros repetits directament.
+// Un numero de n digits format per un bloc de p digits repetit n/p vegades es bloc * R,
+// on R = 1 + 10^p + 10^2p + ... (n/p termes). Aixina que per a cada (n, p) soles hi ha que
+// sumar una progressio aritmetica de blocs. El cost depen del numero de digits, no de l'amplaria del rang.
+
+u128 potencia10(int e)
 {
-    while (!s.empty() && isspace((unsigned char)s.front()))
-        s.erase(s.begin()); // Elimina els espais al principi, perque sino me donava un error pero de locos
-    while (!s.empty() && isspace((unsigned char)s.back()))
-        s.pop_back(); // Igual pero al final
+    u128 r = 1;
+    for (int i = 0; i < e; i++)
+        r *= 10;
+    return r;
+}
+
+int digitos(ull v)
+{
+    int d = 1;
+    while (v >= 10)
+    {
+        v /= 10;
+        d++;
+    }
+    return d;
 }
 
-int repetitions(const std::string &s)
+u128 suma_bloques(int n, int p, ull a, ull b) // Suma dels numeros de n digits que son un bloc de p digits repetit, dins de [a, b]
 {
-    int n = (int)s.size();
-    if (n == 0)
+    u128 R = 0;
+    for (int i = 0; i < n / p; i++)
+        R = R * potencia10(p) + 1;
+
+    u128 lo = potencia10(p - 1); // El bloc no pot començar per 0
+    u128 hi = potencia10(p) - 1;
+    u128 desde = ((u128)a + R - 1) / R; // ceil(a / R)
+    u128 hasta = (u128)b / R;           // floor(b / R)
+    if (desde < lo)
+        desde = lo;
+    if (hasta > hi)
+        hasta = hi;
+    if (desde > hasta)
         return 0;
-    vector<int> pi(n, 0);
-    for (int i = 1; i < n; ++i)
+    return R * ((desde + hasta) * (hasta - desde + 1) / 2);
+}
+
+u128 suma_longitud(int n, ull a, ull b) // Suma dels numeros de n digits en [a, b] que tenen algun periode p < n
+{
+    // Inclusio-exclusio sobre els divisors: un numero de periode minim e apareix en suma_bloques(n, d)
+    // per a tots els d multiples de e. exacte[d] es la suma dels que tenen periode minim exactament d.
+    u128 exacte[21] = {0};
+    u128 total = 0;
+    for (int d = 1; d < n; d++)
     {
-        int j = pi[i - 1];
-        while (j > 0 && s[i] != s[j])
-            j = pi[j - 1];
-        if (s[i] == s[j])
-            ++j;
-        pi[i] = j;
+        if (n % d != 0)
+            continue;
+        exacte[d] = suma_bloques(n, d, a, b);
+        for (int e = 1; e < d; e++)
+            if (d % e == 0)
+                exacte[d] -= exacte[e];
+        total += exacte[d];
     }
+    return total;
+}
+
+ull suma_rango(ull start, ull end)
+{
+    if (start > end)
+        return 0;
+    u128 Nvalid = 0;
+    for (int n = digitos(start); n <= digitos(end); n++)
+        Nvalid += suma_longitud(n, start, end);
+    return (ull)Nvalid;
+}
+
+// Abans feia un stringstream per linea, un string per token, substr i stoll dins de un try/catch.
+// Ara el fitxer es mapeja en memoria i es llig d'una passada sense reservar res, amb from_chars.
+// Els errors es tornen tipats en conter de tragar-se'ls en un catch (...).
 
-    int p = n - pi[n - 1];   // Posible repeticio
-    if (p > 0 && n % p == 0) // Comprovacio
-        return n / p;
-    return 1; // Si no hi ha soles tornes que conte el substring inicial (tots tenen un al menys)
+enum class ErrorRango
+{
+    Ok,
+    Fin,            // No queden mes rangs
+    SinGuion,       // Falta el '-' entre els dos numeros
+    NumeroInvalido, // Hi ha algo que no es un numero
+    Desbordamiento  // El numero no cap en 64 bits
+};
+
+const char *descripcion(ErrorRango e)
+{
+    switch (e)
+    {
+    case ErrorRango::Ok:
+        return "ok";
+    case ErrorRango::Fin:
+        return "fin de la entrada";
+    case ErrorRango::SinGuion:
+        return "falta el guion del rango";
+    case ErrorRango::NumeroInvalido:
+        return "numero invalido";
+    case ErrorRango::Desbordamiento:
+        return "numero demasiado grande";
+    }
+    return "?";
 }
 
-unsigned long long suma_invalido(const string &a, const string &b)
+class ArchivoMapeado // RAII sobre mmap, per a no tindre que copiar el fitxer a un string
 {
-    // Try y Catch perque si no tampoc me anava, si aso es un proba y error molt dur
-    try
+private:
+    int fd = -1;
+    const char *datos = nullptr;
+    size_t tam = 0;
+
+public:
+    explicit ArchivoMapeado(const char *ruta)
     {
-        unsigned long long start = stoll(a);
-        unsigned long long end = stoll(b);
-        if (start > end)
-            return 0;
-        unsigned long long Nvalid = 0;
-        for (unsigned long long v = start; v <= end; ++v)
+        fd = open(ruta, O_RDONLY);
+        if (fd < 0)
+            return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0)
         {
-            string s = to_string(v);
-            int reps = repetitions(s);
-            if (reps > 1)
-                if ((int)s.size() % reps == 0)
-                {
-                    Nvalid += v;
-                }
+            void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED)
+            {
+                datos = (const char *)p;
+                tam = st.st_size;
+                madvise(p, tam, MADV_SEQUENTIAL); // El llegim d'una passada
+            }
         }
-        return Nvalid;
+    }
+    ~ArchivoMapeado()
+    {
+        if (datos)
+            munmap((void *)datos, tam);
+        if (fd >= 0)
+            close(fd);
+    }
+    ArchivoMapeado(const ArchivoMapeado &) = delete;
+    ArchivoMapeado &operator=(const ArchivoMapeado &) = delete;
+
+    bool abierto() const { return fd >= 0; }
+    const char *begin() const { return datos; }
+    const char *end() const { return datos + tam; }
+};
+
+class LectorRangos // Tokenitzador de "a-b,c-d,..." que va tornant parells (lo, hi)
+{
+private:
+    const char *inicio;
+    const char *p;
+    const char *fin;
+
+    void saltar_espacios()
+    {
+        while (p < fin && isspace((unsigned char)*p))
+            ++p;
     }
 
-    catch (...) // Aso no sabia ni que se podia fer, que dur tot
+    ErrorRango leer_numero(ull &v)
     {
-        return 0;
+        auto [ptr, ec] = from_chars(p, fin, v);
+        if (ec == errc::invalid_argument)
+            return ErrorRango::NumeroInvalido;
+        p = ptr; // Si desborda from_chars tambe avança fins al final del numero
+        if (ec == errc::result_out_of_range)
+            return ErrorRango::Desbordamiento;
+        return ErrorRango::Ok;
+    }
+
+public:
+    LectorRangos(const char *b, const char *e) : inicio(b), p(b), fin(e) {}
+
+    ErrorRango siguiente(ull &lo, ull &hi)
+    {
+        while (p < fin && (*p == ',' || isspace((unsigned char)*p)))
+            ++p;
+        if (p == fin)
+            return ErrorRango::Fin;
+
+        ErrorRango e = leer_numero(lo);
+        if (e != ErrorRango::Ok)
+            return e;
+        saltar_espacios();
+        if (p == fin || *p != '-')
+            return ErrorRango::SinGuion;
+        ++p;
+        saltar_espacios();
+        e = leer_numero(hi);
+        if (e != ErrorRango::Ok)
+            return e;
+        while (p < fin && (*p == ' ' || *p == '\t')) // Espais de la mateixa linea, el salt de linea no
+            ++p;
+        if (p < fin && *p != ',' && *p != '\n' && *p != '\r') // El rang acaba en coma, en salt de linea o al final
+            return ErrorRango::NumeroInvalido;
+        return ErrorRango::Ok;
+    }
+
+    void saltar_token() // Per a recuperar-se d'un error: bota fins a la seguent coma o linea
+    {
+        while (p < fin && *p != ',' && *p != '\n')
+            ++p;
+    }
+
+    size_t posicion() const { return p - inicio; }
+};
+
+// Recorre tots els rangs del text cridant f(lo, hi); els que no es poden llegir s'avisen per stderr i es boten
+template <class F>
+void recorrer_rangos(const char *b, const char *e, F &&f)
+{
+    LectorRangos lector(b, e);
+    ull lo, hi;
+    ErrorRango err;
+    while ((err = lector.siguiente(lo, hi)) != ErrorRango::Fin)
+    {
+        if (err != ErrorRango::Ok) // Abans el catch (...) se ho menjava tot sense dir res, ara almenys avisa
+        {
+            cerr << "Rango ignorado en el byte " << lector.posicion() << ": " << descripcion(err) << endl;
+            lector.saltar_token();
+            continue;
+        }
+        f(lo, hi);
     }
 }
 
-int main(void)
+ull sumar_texto(const char *b, const char *e) // Cada rang se suma segons es llig, sense guardar-los
 {
-    string line;
-    unsigned long long Nvalid = 0;
-    ifstream file("input.txt");
-    while (getline(file, line))
+    ull total = 0;
+    recorrer_rangos(b, e, [&](ull lo, ull hi)
+                    { total += suma_rango(lo, hi); });
+    return total;
+}
+
+// Mode paralel. Els rangs tenen amplaries molt diferents, aixina que repartir-los a parts iguals
+// deixa fils parats. Cada fil te la seua cua de tasques: trau per darrere i, si una tasca es gran,
+// la partix i deixa la meitat a la seua cua. Els fils que es queden sense res li roben per davant
+// (on estan els trossos mes grans) a un altre. Cada fil suma en la seua variable i al final es
+// reduix en ordre de fil, aixina l'eixida es sempre la mateixa.
+
+struct Tarea
+{
+    ull lo;
+    ull hi;
+};
+
+class PoolRobo
+{
+private:
+    struct Cola
+    {
+        mutex m;
+        deque<Tarea> tareas;
+    };
+
+    vector<Cola> colas;
+    vector<ull> parciales;
+    atomic<long long> pendientes{0}; // Tasques encara no acabades (en cua o processant-se)
+    bool (*dividir)(const Tarea &, Tarea &, Tarea &);
+    ull (*procesar)(const Tarea &);
+
+    void empujar(int id, const Tarea &t)
+    {
+        pendientes++;
+        lock_guard<mutex> lock(colas[id].m);
+        colas[id].tareas.push_back(t);
+    }
+
+    bool sacar(int id, Tarea &t) // El propi fil trau per darrere (lo ultim que ha partit, mes calent en cache)
+    {
+        lock_guard<mutex> lock(colas[id].m);
+        if (colas[id].tareas.empty())
+            return false;
+        t = colas[id].tareas.back();
+        colas[id].tareas.pop_back();
+        return true;
+    }
+
+    bool robar(int id, Tarea &t) // Els lladres trauen per davant
+    {
+        int n = colas.size();
+        for (int k = 1; k < n; k++)
+        {
+            Cola &victima = colas[(id + k) % n];
+            lock_guard<mutex> lock(victima.m);
+            if (!victima.tareas.empty())
+            {
+                t = victima.tareas.front();
+                victima.tareas.pop_front();
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void trabajar(int id)
     {
-        stringstream ss(line);
-        string token;
-        while (getline(ss, token, ',')) // Aso me ho apute, perque ho he tret de un problema antic de CodeForces
+        Tarea t;
+        while (pendientes > 0)
         {
-            espacios(token);
-            int pos = token.find('-');
+            if (!sacar(id, t) && !robar(id, t))
+            {
+                this_thread::yield();
+                continue;
+            }
+            Tarea a, b;
+            while (dividir(t, a, b)) // Mentres siga gran, partix i deixa la segona meitat per a qui la vullga
+            {
+                empujar(id, b);
+                t = a;
+            }
+            parciales[id] += procesar(t);
+            pendientes--;
+        }
+    }
+
+public:
+    PoolRobo(int hilos, bool (*d)(const Tarea &, Tarea &, Tarea &), ull (*p)(const Tarea &))
+        : colas(hilos), parciales(hilos, 0), dividir(d), procesar(p) {}
 
-            string id1 = token.substr(0, pos);
-            string id2 = token.substr(pos + 1);
+    ull ejecutar(const vector<Tarea> &tareas)
+    {
+        int n = colas.size();
+        for (int i = 0; i < (int)tareas.size(); i++) // Repartiment inicial a la babalà, ja s'equilibrara robant
+            empujar(i % n, tareas[i]);
 
-            espacios(id1);
-            espacios(id2);
+        vector<thread> hilos;
+        for (int id = 0; id < n; id++)
+            hilos.emplace_back(&PoolRobo::trabajar, this, id);
+        for (thread &h : hilos)
+            h.join();
 
-            Nvalid += suma_invalido(id1, id2);
+        ull total = 0;
+        for (ull p : parciales) // Reduccio en ordre fix
+            total += p;
+        return total;
+    }
+};
+
+// Amb la formula tancada el cost d'un rang depen dels digits, no de l'amplaria,
+// aixina que una tasca es "gran" quan abarca moltes longituds i es partix per una potencia de 10.
+bool dividir_por_digitos(const Tarea &t, Tarea &a, Tarea &b)
+{
+    int dlo = digitos(t.lo), dhi = digitos(t.hi);
+    if (t.lo > t.hi || dlo == dhi)
+        return false;
+    ull corte = (ull)potencia10((dlo + dhi) / 2); // Primer numero de (dlo+dhi)/2 + 1 digits, mes o menys a la mitat
+    a = {t.lo, corte - 1};
+    b = {corte, t.hi};
+    return true;
+}
+
+ull procesar_rango(const Tarea &t)
+{
+    return suma_rango(t.lo, t.hi);
+}
+
+// Per al mode paralel si que cal tindre tots els rangs en memoria per a repartir-los
+vector<Tarea> leer_rangos(const char *b, const char *e)
+{
+    vector<Tarea> rangos;
+    recorrer_rangos(b, e, [&](ull lo, ull hi)
+                    { rangos.push_back({lo, hi}); });
+    return rangos;
+}
+
+// --prueba: el mateix exemple de l'enunciat escrit de diverses maneres (una linea, una per linea, CRLF,
+// comes al final de linea...) ha de donar sempre el mateix resultat
+int prueba()
+{
+    const char *rangos[] = {"11-22", "95-115", "998-1012", "1188511880-1188511890", "222220-222224", "1698522-1698528",
+                            "446443-446449", "38593856-38593862", "565653-565659", "824824821-824824827", "2121212118-2121212124"};
+    const ull esperado = 4174379265ULL;
+    const char *separadores[] = {",", "\n", "\r\n", ",\n", " \n", ", "};
+    int fallos = 0;
+    for (const char *sep : separadores)
+    {
+        for (int final_linea = 0; final_linea < 2; final_linea++)
+        {
+            string texto;
+            for (size_t i = 0; i < sizeof(rangos) / sizeof(rangos[0]); i++)
+                texto += (i ? sep : "") + string(rangos[i]);
+            if (final_linea)
+                texto += "\n";
+            ull r = sumar_texto(texto.data(), texto.data() + texto.size());
+            PoolRobo pool(3, dividir_por_digitos, procesar_rango); // I el mateix pel cami paralel
+            ull rp = pool.ejecutar(leer_rangos(texto.data(), texto.data() + texto.size()));
+            if (r != esperado || rp != esperado)
+            {
+                cerr << "Fallo con el separador \"" << (sep[0] == ',' ? sep : "salto de linea") << "\": " << r << " / " << rp
+                     << " en lugar de " << esperado << endl;
+                fallos++;
+            }
         }
     }
+    // Un rang roin no s'ha de menjar la linea seguent
+    string texto = "11-22\nabc\n95-115\n";
+    ull r = sumar_texto(texto.data(), texto.data() + texto.size());
+    if (r != suma_rango(11, 22) + suma_rango(95, 115))
+    {
+        cerr << "Fallo al saltar una linea invalida: " << r << endl;
+        fallos++;
+    }
+    cout << (fallos ? "Pruebas fallidas: " : "Pruebas correctas") << (fallos ? to_string(fallos) : "") << endl;
+    return fallos ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int hilos = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            hilos = max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--prueba") == 0)
+            return prueba();
+        else
+        {
+            cerr << "Uso: " << argv[0] << " [--threads N] [--prueba]" << endl;
+            return 1;
+        }
+    }
+
+    unsigned long long Nvalid = 0;
+    ArchivoMapeado file("input.txt");
+    if (!file.abierto())
+    {
+        cerr << "No se pudo abrir el archivo" << endl;
+        return 1;
+    }
+
+    if (hilos == 1)
+        Nvalid = sumar_texto(file.begin(), file.end());
+    else
+    {
+        PoolRobo pool(hilos, dividir_por_digitos, procesar_rango);
+        Nvalid = pool.ejecutar(leer_rangos(file.begin(), file.end()));
+    }
 
     cout << Nvalid << '\n';
     return 0;
-}
\ No newline at end of file
+}
@@ -4,6 +4,7 @@
 #include <vector>
 #include <limits>
 #include <cmath>
+#include <cstring>
 
 #define nBateries 12
 
@@ -21,7 +22,7 @@ long inf = numeric_limits<long>::min();
 long maxBat(string &l1, int i, int j, vector <vector<long> > &memo){
 	// casos base
     if (j == nBateries) {return 0;}
-	else if(i >= l1.size()) {return -inf;}
+	else if(i >= l1.size()) {return inf;} // no queden prou digits, cami impossible (abans -inf, que es desbordava)
     else if (memo[i][j] != -1) {return memo[i][j];}
     
 	// casos general + memoria
@@ -31,17 +32,122 @@ long maxBat(string &l1, int i, int j, vector <vector<long> > &memo){
     return memo[i][j];
 }
 
+/*
+La PD reserva una memo de n x 13 per cada linea i fa recursio fins a n*12 de fondaria,
+en linies llargues peta la pila. Els altres dos motors no fan recursio i reutilitzen
+el mateix espai de treball (un per fil) entre linies, aixi no es reserva memoria a cada linea.
+  - greedy: pila monotona, O(n)
+  - sparse: taula dispersa de maxims, cada digit es una consulta O(1) a la finestra on pot estar
+Han de donar exactament lo mateix que la PD (--comprobar ho mira linea a linea).
+*/
+struct Rascador
+{
+    vector<int> pila;
+    vector<vector<int> > taula; // taula[j][i] = posicio del maxim en [i, i + 2^j), la primera si hi ha empat
+    vector<int> log2;
+};
+thread_local Rascador rascador;
+
+long greedyBat(const string &l1){
+    vector<int> &pila = rascador.pila;
+    pila.clear(); // clear no allibera, la capacitat es queda pa la seguent linea
+
+    int n = l1.size();
+    int quitar = max(0, n - nBateries);
+    for (char c : l1)
+    {
+        int d = c - '0';
+        while (!pila.empty() && quitar > 0 && pila.back() < d) {pila.pop_back(); quitar--;}
+        pila.push_back(d);
+    }
+    long res = 0;
+    for (int i = 0; i < nBateries && i < (int)pila.size(); i++) {res = res * 10 + pila[i];}
+    return res;
+}
+
+long sparseBat(const string &l1){
+    int n = l1.size();
+    if (n == 0) {return 0;}
+    vector<vector<int> > &taula = rascador.taula;
+    vector<int> &lg = rascador.log2;
+
+    if ((int)lg.size() < n + 1) {
+        lg.assign(n + 1, 0);
+        for (int i = 2; i <= n; i++) {lg[i] = lg[i / 2] + 1;}
+    }
+    int nivells = lg[n] + 1;
+    if ((int)taula.size() < nivells) {taula.resize(nivells);}
+    for (int j = 0; j < nivells; j++) {if ((int)taula[j].size() < n) taula[j].resize(n);} // soles creix
+
+    for (int i = 0; i < n; i++) {taula[0][i] = i;}
+    for (int j = 1; j < nivells; j++) {
+        for (int i = 0; i + (1 << j) <= n; i++) {
+            int a = taula[j - 1][i], b = taula[j - 1][i + (1 << (j - 1))];
+            taula[j][i] = (l1[b] > l1[a]) ? b : a; // en empat el de l'esquerra
+        }
+    }
+
+    long res = 0;
+    int pos = 0;
+    int k = min(nBateries, n);
+    for (int j = 0; j < k; j++)
+    {
+        int fi = n - (k - j); // el digit j pot estar en [pos, fi]
+        int niv = lg[fi - pos + 1];
+        int a = taula[niv][pos], b = taula[niv][fi - (1 << niv) + 1];
+        int millor = (l1[b] > l1[a]) ? b : a;
+        res = res * 10 + (l1[millor] - '0');
+        pos = millor + 1;
+    }
+    return res;
+}
+
+long dpBat(string &l1){
+    // Amb 12 digits o menys no hi ha res que triar i la PD no troba cap cami de 12: s'agafen tots,
+    // igual que greedy, sparse i Dia3/parte2.cpp
+    if (l1.size() <= nBateries) {
+        long res = 0;
+        for (char c : l1) {res = res * 10 + (c - '0');}
+        return res;
+    }
+    int estadoBusqueda = 0;
+    vector <vector<long> > memo(l1.size(),vector<long>(nBateries + 1,-1));
+    return maxBat(l1, 0, estadoBusqueda, memo);
+}
+
 int main(int argc, char const *argv[])
 {
+    string motor = "dp";
+    bool comprobar = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--engine") == 0 && i + 1 < argc) {motor = argv[++i];}
+        else if (strcmp(argv[i], "--comprobar") == 0) {comprobar = true;}
+    }
+    if (motor != "dp" && motor != "greedy" && motor != "sparse") {
+        cerr << "Uso: " << argv[0] << " [--engine dp|greedy|sparse] [--comprobar]" << endl;
+        return 1;
+    }
+
     ifstream fich("input.txt");
     string l1;
-    long count = 0;  
+    long count = 0;
+    int nLinea = 0;
     while (getline(fich, l1))
     {
-        if (l1.back() == '\r') l1.pop_back(); // caracter perillos que esta al final
-        int estadoBusqueda = 0;
-        vector <vector<long> > memo(l1.size(),vector<long>(nBateries + 1,-1));
-        count += maxBat(l1, 0, estadoBusqueda, memo);
+        if (!l1.empty() && l1.back() == '\r') l1.pop_back(); // caracter perillos que esta al final
+        nLinea++;
+        if (comprobar) { // els tres han de donar lo mateix
+            long a = dpBat(l1), b = greedyBat(l1), c = sparseBat(l1);
+            if (a != b || a != c) {
+                cerr << "Linea " << nLinea << ": dp=" << a << " greedy=" << b << " sparse=" << c << endl;
+                return 1;
+            }
+            count += a;
+        }
+        else if (motor == "greedy") {count += greedyBat(l1);}
+        else if (motor == "sparse") {count += sparseBat(l1);}
+        else {count += dpBat(l1);}
     }
     cout << count << endl;
     fich.close();
@@ -0,0 +1,265 @@
+// Les dos parts a la volta i en paralel. Cada linea (banc de bateries) es independent, aixina que:
+//   1. El fitxer es llig en blocs grans (mentres es processa un bloc ja s'esta llegint el seguent).
+//   2. Cada bloc es partix en linees sense copiar res: soles es guarda on comença i quant mesura cada una.
+//   3. Les linees es reparteixen en lots entre els fils, que sumen en el seu parcial.
+//   4. Al final es sumen els parcials i es mostra el rendiment (linees/s i bytes/s) per stderr.
+// El kernel de cada linea es el mateix que el de parte2.cpp (maxim de la finestra + memchr).
+//
+// Compilar: g++ -std=c++17 -O2 -pthread -o Dia3Paralelo Dia3Paralelo.cpp
+// Executar: ./Dia3Paralelo [--threads N] [fitxer]
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <chrono>
+#include <stdexcept>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <unistd.h>
+
+typedef unsigned long long ull;
+
+using namespace std;
+
+const size_t TAM_BLOQUE = 16 << 20; // 16 MB per bloc
+const int LOTE = 4096;              // Linees per lot
+const int MAX_BANCO = 1 << 16;
+const int BLOQUE_SIMD = 64;
+
+inline uint8_t maximo_bloque(const uint8_t *d, int n)
+{
+    uint8_t m = 0;
+    for (int i = 0; i < n; i++)
+        m = (d[i] > m) ? d[i] : m;
+    return m;
+}
+
+uint8_t maximo_ventana(const uint8_t *d, int n)
+{
+    uint8_t m = 0;
+    for (int i = 0; i < n; i += BLOQUE_SIMD)
+    {
+        uint8_t b = maximo_bloque(d + i, min(BLOQUE_SIMD, n - i));
+        m = (b > m) ? b : m;
+        if (m == 9)
+            break;
+    }
+    return m;
+}
+
+// Torna el resultat per a k = 2 (parte1) i k = 12 (parte2) de la mateixa linea, aixina els digits es copien una volta
+void maximo_potencial(const char *linea, int len, ull &parte1, ull &parte2)
+{
+    uint8_t digitos[MAX_BANCO];
+    int n = 0;
+    for (int i = 0; i < len; i++)
+    {
+        char c = linea[i];
+        if (c < '0' || c > '9')
+            continue;
+        if (n == MAX_BANCO)
+            throw runtime_error("Linea demasiado larga");
+        digitos[n++] = (uint8_t)(c - '0');
+    }
+
+    const int ks[2] = {2, 12};
+    ull res[2] = {0, 0};
+    for (int t = 0; t < 2; t++)
+    {
+        int k = ks[t];
+        if (n <= k)
+        {
+            // Com en parte1.cpp i parte2.cpp: sense parella (menys de 2 digits) la parte1 dona 0,
+            // en canvi la parte2 agafa tots els digits que hi haja
+            if (k == 12 || n == k)
+                for (int i = 0; i < n; i++)
+                    res[t] = res[t] * 10 + digitos[i];
+            continue;
+        }
+        int pos = 0;
+        for (int j = 0; j < k; j++)
+        {
+            int ventana = (n - (k - j)) - pos + 1;
+            uint8_t m = maximo_ventana(digitos + pos, ventana);
+            const uint8_t *donde = (const uint8_t *)memchr(digitos + pos, m, ventana);
+            pos = (int)(donde - digitos) + 1;
+            res[t] = res[t] * 10 + m;
+        }
+    }
+    parte1 = res[0];
+    parte2 = res[1];
+}
+
+struct Linea
+{
+    uint32_t inicio;
+    uint32_t longitud;
+};
+
+struct Bloque
+{
+    vector<char> datos;
+    size_t usado = 0;
+    bool fin = false; // S'ha arribat al final del fitxer
+};
+
+// Copia el resto (tros de linea que va quedar a mitges en el bloc anterior) i ompli la resta del bloc llegint
+void leer_bloque(int fd, Bloque &b, const char *resto, size_t nresto)
+{
+    if (b.datos.size() < TAM_BLOQUE + nresto)
+        b.datos.resize(TAM_BLOQUE + nresto);
+    memmove(b.datos.data(), resto, nresto);
+    b.usado = nresto;
+    b.fin = false;
+    while (b.usado < b.datos.size())
+    {
+        ssize_t r = read(fd, b.datos.data() + b.usado, b.datos.size() - b.usado);
+        if (r < 0)
+            throw runtime_error("Error leyendo el archivo");
+        if (r == 0)
+        {
+            b.fin = true;
+            break;
+        }
+        b.usado += r;
+    }
+}
+
+void partir_lineas(const char *d, size_t n, vector<Linea> &lineas) // Soles apunta on estan, no copia
+{
+    lineas.clear();
+    size_t i = 0;
+    while (i < n)
+    {
+        const char *nl = (const char *)memchr(d + i, '\n', n - i);
+        size_t fin = nl ? (size_t)(nl - d) : n;
+        size_t len = fin - i;
+        if (len > 0 && d[fin - 1] == '\r')
+            len--;
+        lineas.push_back({(uint32_t)i, (uint32_t)len});
+        i = fin + 1;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    int hilos = max(1u, thread::hardware_concurrency());
+    const char *ruta = "input.txt";
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            hilos = max(1, atoi(argv[++i]));
+        else
+            ruta = argv[i];
+    }
+
+    int fd = open(ruta, O_RDONLY);
+    if (fd < 0)
+        throw runtime_error("No se pudo abrir el archivo");
+
+    auto t0 = chrono::steady_clock::now();
+    vector<ull> parcial1(hilos, 0), parcial2(hilos, 0);
+    vector<Linea> lineas;
+    ull total_lineas = 0, total_bytes = 0;
+
+    Bloque bloques[2];
+    int actual = 0;
+    leer_bloque(fd, bloques[actual], nullptr, 0);
+    while (bloques[actual].usado > 0)
+    {
+        Bloque &b = bloques[actual];
+        size_t corte = b.usado; // Fins on hi ha linees completes
+        if (!b.fin)
+        {
+            const char *nl = (const char *)memrchr(b.datos.data(), '\n', b.usado);
+            if (!nl)
+                throw runtime_error("Linea mas larga que el bloque");
+            corte = (nl - b.datos.data()) + 1;
+        }
+
+        // Mentres es processa este bloc, el seguent ja es va llegint
+        Bloque &sig = bloques[1 - actual];
+        future<void> lectura;
+        if (!b.fin)
+            lectura = async(launch::async, leer_bloque, fd, ref(sig), b.datos.data() + corte, b.usado - corte);
+        else
+            sig.usado = 0;
+
+        partir_lineas(b.datos.data(), corte, lineas);
+        atomic<size_t> siguiente_lote{0};
+        size_t nlotes = (lineas.size() + LOTE - 1) / LOTE;
+        // Una excepcio dins d'un thread acaba el programa sense avisar, aixina que cada fil guarda
+        // el seu error (i en quina linea) i para el repartiment; es mostra despres del join
+        vector<string> error(hilos);
+        vector<size_t> linea_error(hilos, SIZE_MAX);
+        vector<thread> trabajadores;
+        for (int id = 0; id < hilos; id++)
+        {
+            trabajadores.emplace_back([&, id]()
+                                      {
+                size_t lote;
+                while ((lote = siguiente_lote++) < nlotes)
+                {
+                    size_t fin = min(lineas.size(), (lote + 1) * LOTE);
+                    for (size_t i = lote * LOTE; i < fin; i++)
+                    {
+                        ull p1, p2;
+                        try
+                        {
+                            maximo_potencial(b.datos.data() + lineas[i].inicio, lineas[i].longitud, p1, p2);
+                        }
+                        catch (const exception &e)
+                        {
+                            error[id] = e.what();
+                            linea_error[id] = i;
+                            siguiente_lote = nlotes;
+                            return;
+                        }
+                        parcial1[id] += p1;
+                        parcial2[id] += p2;
+                    }
+                } });
+        }
+        for (thread &t : trabajadores)
+            t.join();
+
+        int fallo = -1; // Si n'hi ha varios, el de la primera linea
+        for (int id = 0; id < hilos; id++)
+            if (linea_error[id] != SIZE_MAX && (fallo < 0 || linea_error[id] < linea_error[fallo]))
+                fallo = id;
+        if (fallo >= 0)
+        {
+            if (lectura.valid())
+                lectura.wait();
+            close(fd);
+            cerr << "Error en la linea " << total_lineas + linea_error[fallo] + 1 << ": " << error[fallo] << endl;
+            return 1;
+        }
+
+        total_lineas += lineas.size();
+        total_bytes += corte;
+        if (lectura.valid())
+            lectura.get(); // Espera (i propaga errors de) la lectura del seguent bloc
+        actual = 1 - actual;
+    }
+    close(fd);
+
+    ull suma1 = 0, suma2 = 0;
+    for (int id = 0; id < hilos; id++)
+    {
+        suma1 += parcial1[id];
+        suma2 += parcial2[id];
+    }
+    double segundos = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+
+    cout << "Parte 1: " << suma1 << endl;
+    cout << "Parte 2: " << suma2 << endl;
+    cerr << total_lineas << " lineas, " << total_bytes << " bytes en " << segundos << " s ("
+         << (ull)(total_lineas / segundos) << " lineas/s, " << (ull)(total_bytes / segundos / (1 << 20)) << " MB/s, "
+         << hilos << " hilos)" << endl;
+    return 0;
+}
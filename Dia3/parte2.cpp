@@ -1,46 +1,86 @@
-// Utilizaremos pilas y greedy para resolver el problema. Igual que el anterior pero para k = 12
+// Greedy igual que el anterior pero per a k = 12 (o la k que se li passe amb --k).
+// Abans era una pila (stack<int>, que per dins es un deque) i despres es reconstruia el numero
+// desapilant. Ara els digits van a un buffer fix en la pila del programa i per a cada posicio del
+// resultat es busca el maxim de la finestra on pot estar, en un bucle sense branques que el
+// compilador vectoritza, i despres memchr per a trobar la primera aparicio.
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <stdexcept>
-#include <stack>
-#include <vector>
+#include <cstring>
+#include <cstdint>
 
 typedef unsigned long long ull;
 
 using namespace std;
 
-void maximo_potencial(const string &numero, stack<int> &pila)
-{ // 7364324241225433445422232322233434224835321253334532333323166227675321322533332522422446233324232434
-    int k = 12;
-    int n = (int)numero.size(); // No se que retornen estes coses pero si no les convertixc (cast) sempre me dona problemes
-    int eliminar_12 = (n - k);  // IIS me ha acostumat a gastar els parentesis, sino ara ho vec raro
-    if (eliminar_12 < 0)        // Me pegava una rallaes si no feia aso.
+const int MAX_BANCO = 1 << 16; // Capacitat del buffer de digits (la linea mes llarga que acceptem)
+const int MAX_K = 19;          // Mes digits no caben en un ull
+const int BLOQUE = 64;         // La finestra es recorre en blocs, per a poder parar prompte si trobem un 9
+
+inline uint8_t maximo_bloque(const uint8_t *d, int n) // Sense ifs dins, aixina el compilador fa servir SIMD
+{
+    uint8_t m = 0;
+    for (int i = 0; i < n; i++)
+        m = (d[i] > m) ? d[i] : m;
+    return m;
+}
+
+uint8_t maximo_ventana(const uint8_t *d, int n)
+{
+    uint8_t m = 0;
+    for (int i = 0; i < n; i += BLOQUE)
     {
-        eliminar_12 = 0;
+        uint8_t b = maximo_bloque(d + i, min(BLOQUE, n - i));
+        m = (b > m) ? b : m;
+        if (m == 9) // Mes que 9 no n'hi ha, no cal mirar mes
+            break;
     }
+    return m;
+}
 
+ull maximo_potencial(const string &numero, int k)
+{ // 7364324241225433445422232322233434224835321253334532333323166227675321322533332522422446233324232434
+    uint8_t digitos[MAX_BANCO];
+    int n = 0;
     for (char c : numero)
     {
         if (c < '0' || c > '9') // Per si acas, no sas lo que se pots troabar en els Inputs
             continue;
-        int digito = (c - '0');
-        while (!pila.empty() && (eliminar_12 > 0) && (pila.top() < digito))
-        {
-            pila.pop();
-            (eliminar_12--);
-        }
-        pila.push(digito);
+        if (n == MAX_BANCO)
+            throw runtime_error("Linea demasiado larga");
+        digitos[n++] = (uint8_t)(c - '0');
     }
-    while (eliminar_12 > 0 && !pila.empty())
+
+    ull resultado = 0;
+    if (n <= k) // Si no n'hi ha prou, s'agafen tots
+    {
+        for (int i = 0; i < n; i++)
+            resultado = resultado * 10 + digitos[i];
+        return resultado;
+    }
+
+    int pos = 0;
+    for (int j = 0; j < k; j++)
     {
-        pila.pop();
-        (eliminar_12--);
+        // El digit j del resultat pot estar entre pos i n - (k - j), perque encara n'han de quedar k - j - 1 darrere
+        int ventana = (n - (k - j)) - pos + 1;
+        uint8_t m = maximo_ventana(digitos + pos, ventana);
+        const uint8_t *donde = (const uint8_t *)memchr(digitos + pos, m, ventana); // Primera aparicio, per a deixar mes digits darrere
+        pos = (int)(donde - digitos) + 1;
+        resultado = resultado * 10 + m;
     }
+    return resultado;
 }
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    int k = 12;
+    if (argc == 3 && strcmp(argv[1], "--k") == 0)
+        k = atoi(argv[2]);
+    if (k < 1 || k > MAX_K)
+        throw runtime_error("k tiene que estar entre 1 y 19");
+
     ull suma = 0;
     string line;
     ifstream file("input.txt");
@@ -49,22 +89,9 @@ int main(void)
         throw runtime_error("No se pudo abrir el archivo");
     while (getline(file, line))
     {
-        stack<int> pila;
-        maximo_potencial(line, pila);
-
-        ull numero = 0;
-        ull mult = 1;
-        for (int i = 0; i < 12 && !pila.empty(); i++)
-        {
-            int top = pila.top(); // Guardamos el tope porque si utilizo directamente pila.top() para calcular me da error y no se porque
-            pila.pop();           // Ahora si lo quito
-            // if (top == -1) break; // Per si acas
-            numero += (top * mult); // Gatar el pow() me donava problemes aixina que ha fero per força bruta
-            mult *= 10;             // Que locura
-        }
-        suma += numero;
+        suma += maximo_potencial(line, k);
     }
     file.close();
     cout << suma << endl;
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,154 @@
+// Las dos partes con la rejilla guardada como bitboard: un bit por casilla, cada fila en palabras de 64 bits.
+// Para contar los 8 vecinos no se mira casilla a casilla; se desplazan palabras enteras (izquierda/derecha)
+// y se suman los 8 planos de bits con sumadores completos bit a bit (bit-sliced). Asi cada palabra procesa
+// 64 casillas a la vez sin ningun if, y una pasada por la rejilla son unas pocas lecturas de memoria.
+//
+// Compilar: g++ -std=c++17 -O2 -o Dia4Bitboard Dia4Bitboard.cpp
+// Ejecutar: ./Dia4Bitboard            (resuelve input.txt)
+//           ./Dia4Bitboard --bench N  (mide una pasada sobre una rejilla aleatoria de N x N)
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include "../Comun/Rejilla.h"
+
+using namespace std;
+
+typedef uint64_t u64;
+
+class Bitboard
+{
+private:
+    int filas;
+    int columnas;
+    int palabras;  // Palabras por fila
+    vector<u64> bits; // (filas + 2) filas de 'palabras' palabras; la primera y la ultima son de relleno (a 0)
+
+    // La columna c esta en el bit c + 1, el bit 0 de la primera palabra es el relleno de la izquierda
+    u64 *fila(int r) { return bits.data() + (size_t)(r + 1) * palabras; }
+    const u64 *fila(int r) const { return bits.data() + (size_t)(r + 1) * palabras; }
+
+    static u64 desdeIzquierda(const u64 *f, int w) // Bit i <- bit i-1 (el vecino de la izquierda)
+    {
+        return (f[w] << 1) | (w > 0 ? f[w - 1] >> 63 : 0);
+    }
+
+    static u64 desdeDerecha(const u64 *f, int w, int n) // Bit i <- bit i+1 (el vecino de la derecha)
+    {
+        return (f[w] >> 1) | (w + 1 < n ? f[w + 1] << 63 : 0);
+    }
+
+    // Marca en 'salida' las casillas con rollo y menos de 4 vecinos en la fila r
+    void accesiblesFila(int r, u64 *salida) const
+    {
+        const u64 *arriba = fila(r - 1);
+        const u64 *medio = fila(r);
+        const u64 *abajo = fila(r + 1);
+        for (int w = 0; w < palabras; w++)
+        {
+            u64 x0 = desdeIzquierda(arriba, w), x1 = arriba[w], x2 = desdeDerecha(arriba, w, palabras);
+            u64 x3 = desdeIzquierda(medio, w), x4 = desdeDerecha(medio, w, palabras);
+            u64 x5 = desdeIzquierda(abajo, w), x6 = abajo[w], x7 = desdeDerecha(abajo, w, palabras);
+
+            // Sumadores completos: s = suma, c = acarreo (peso 2)
+            u64 s1 = x0 ^ x1 ^ x2, c1 = (x0 & x1) | (x2 & (x0 ^ x1));
+            u64 s2 = x3 ^ x4 ^ x5, c2 = (x3 & x4) | (x5 & (x3 ^ x4));
+            u64 s3 = x6 ^ x7, c3 = x6 & x7;
+            u64 c4 = (s1 & s2) | (s3 & (s1 ^ s2)); // Acarreo de sumar las unidades
+            // Los cuatro acarreos de peso 2; lo que salga de aqui ya pesa 4
+            u64 t1 = c1 ^ c2 ^ c3, d1 = (c1 & c2) | (c3 & (c1 ^ c2));
+            u64 d2 = t1 & c4;
+            u64 cuatroOMas = d1 | d2;
+            salida[w] = medio[w] & ~cuatroOMas;
+        }
+    }
+
+public:
+    Bitboard(int f, int c) : filas(f), columnas(c), palabras((c + 2 + 63) / 64), bits((size_t)(f + 2) * palabras, 0) {}
+
+    void poner(int r, int c) { fila(r)[(c + 1) >> 6] |= (u64)1 << ((c + 1) & 63); }
+
+    // Calcula todas las accesibles a la vez (ronda sincrona). Devuelve cuantas hay.
+    long long accesibles(vector<u64> &marcadas) const
+    {
+        marcadas.assign((size_t)filas * palabras, 0);
+        long long total = 0;
+        for (int r = 0; r < filas; r++)
+        {
+            u64 *salida = marcadas.data() + (size_t)r * palabras;
+            accesiblesFila(r, salida);
+            for (int w = 0; w < palabras; w++)
+                total += __builtin_popcountll(salida[w]);
+        }
+        return total;
+    }
+
+    void quitar(const vector<u64> &marcadas)
+    {
+        for (int r = 0; r < filas; r++)
+        {
+            u64 *f = fila(r);
+            const u64 *m = marcadas.data() + (size_t)r * palabras;
+            for (int w = 0; w < palabras; w++)
+                f[w] &= ~m[w];
+        }
+    }
+
+    long long eliminarEnCascada() // Rondas de quitar todas las accesibles hasta que no quede ninguna
+    {
+        vector<u64> marcadas;
+        long long total = 0, ronda;
+        while ((ronda = accesibles(marcadas)) > 0)
+        {
+            quitar(marcadas);
+            total += ronda;
+        }
+        return total;
+    }
+};
+
+int bench(int n)
+{
+    Bitboard tablero(n, n);
+    mt19937 gen(2025);
+    for (int r = 0; r < n; r++)
+        for (int c = 0; c < n; c++)
+            if (gen() % 10 < 6)
+                tablero.poner(r, c);
+
+    vector<u64> marcadas;
+    auto t0 = chrono::steady_clock::now();
+    long long acc = tablero.accesibles(marcadas);
+    double s = chrono::duration<double>(chrono::steady_clock::now() - t0).count();
+    cout << "Pasada sobre " << n << "x" << n << ": " << acc << " accesibles en " << s * 1000 << " ms ("
+         << (double)n * n / s / 1e9 << " Gcasillas/s)" << endl;
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc == 3 && strcmp(argv[1], "--bench") == 0)
+        return bench(atoi(argv[2]));
+
+    Rejilla matriz;
+    if (!matriz.abrir("input.txt"))
+    {
+        cerr << "Error: No se pudo abrir el archivo input.txt\n";
+        return 1;
+    }
+
+    Bitboard tablero(matriz.filas(), matriz.columnas());
+    for (int i = 0; i < matriz.filas(); i++)
+        for (int j = 0; j < matriz.columnas(); j++)
+            if (matriz.at(i, j) == '@')
+                tablero.poner(i, j);
+
+    vector<u64> marcadas;
+    cout << "Parte 1: " << tablero.accesibles(marcadas) << endl;
+    cout << "Parte 2: " << tablero.eliminarEnCascada() << endl;
+    return 0;
+}
@@ -3,10 +3,11 @@
 
 #include <iostream>
 #include <vector>
-#include <queue>
-#include <map>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include "../Comun/Rejilla.h"
 #include <string>
-#include <fstream>
 
 using namespace std;
 
@@ -27,162 +28,135 @@ public:
         return fila == (otra.fila) && (columna == otra.columna);
     }
 
-    bool operator<(const Posicion &otra) const // Para usar map en lugar de unordered_map
-    {
-        if (fila != otra.fila)
-            return fila < otra.fila;
-        return columna < otra.columna;
-    }
-
     void mostrar() const // Ho vaig fer per a enterarme de algo quan feia el debug, per a vore on tenia els errors
     {
         cout << "(" << fila << "," << columna << ")";
     }
 };
 
-class Nodo // Asi comença lo bo, clase Nodo de la que estara compost el grafo
+// Antes cada nodo vivia en un map<Posicion, Nodo> con su propio vector de vecinos, y cada obtenerNodo era
+// bajar por un arbol. Ahora el grafo esta en arrays contiguos (estilo CSR): el nodo de (fila, columna) es el
+// indice (fila + 1) * ancho + (columna + 1), con un borde de relleno alrededor para no comprobar limites.
+// Los vecinos no se guardan: son siempre las 8 casillas de alrededor, que estan a un desplazamiento fijo.
+
+class GrafoRollos // I asi ja comencen els Grafos complets
 {
 private:
-    Posicion posicion;
-    int grado; // Cantidad de vecinos activos (no eliminados)
-    bool eliminado;
-    vector<Posicion> vecinos; // Almacenamos posiciones en lugar de punteros
-
-public:
-    // Constructor
-    Nodo(const Posicion &pos) : posicion(pos), grado(0), eliminado(false) {}
-
-    // Getters
-    Posicion getPosicion() const { return posicion; }
-    int getGrado() const { return grado; }
-    bool estaEliminado() const { return eliminado; }
+    int filas;
+    int columnas;
+    int ancho;                  // columnas + 2 (el relleno)
+    vector<uint8_t> esRollo;    // 1 si en la casilla hay un rollo (nodo del grafo)
+    vector<uint8_t> grado;      // Cantidad de vecinos activos (no eliminados)
+    vector<uint8_t> eliminado;
+    int desplazamientos[8];     // Los 8 vecinos de un indice son indice + desplazamientos[k]
+    int numNodos;
 
-    // Setters
-    void setGrado(int g) { grado = g; }
+    int indice(int f, int c) const { return (f + 1) * ancho + (c + 1); }
+    Posicion posicion(int id) const { return Posicion(id / ancho - 1, id % ancho - 1); }
 
-    void agregarVecino(const Posicion &vecino) // Como unir los nodos (agregar un vecino) y se le aumenta el grado
+    bool esAccesible(int id) const // Comprovar si es accesible (grau < 4 i no eliminat)
     {
-        vecinos.push_back(vecino);
-        grado++;
+        return esRollo[id] && !eliminado[id] && grado[id] < 4;
     }
 
-    void setEliminado(bool e) { eliminado = e; }
-
-    void reducirGrado() // Asi es reduix el grau
+    class ColaCircular // Cola de la BFS sobre un buffer reservado de antemano, sin memoria nueva en cada push
     {
-        if (!eliminado)
+    private:
+        vector<int> buffer;
+        size_t cabeza = 0;
+        size_t cantidad = 0;
+
+    public:
+        explicit ColaCircular(size_t capacidad) : buffer(capacidad > 0 ? capacidad : 1) {}
+        bool vacia() const { return cantidad == 0; }
+        void push(int id)
         {
-            grado--;
+            buffer[(cabeza + cantidad) % buffer.size()] = id;
+            cantidad++;
         }
-    }
-
-    const vector<Posicion> &getVecinos() const
-    {
-        return vecinos;
-    }
-
-    bool esAccesible() const // Comprovar si es accesible (grau < 4 i no eliminat)
-    {
-        return !eliminado && grado < 4;
-    }
+        int pop()
+        {
+            int id = buffer[cabeza];
+            cabeza = (cabeza + 1) % buffer.size();
+            cantidad--;
+            return id;
+        }
+    };
 
-    void mostrar() const // Mostrar info del nodo per a poder deuguear i vore on comença tot a anar malament
+    // Reparte las filas en bandas contiguas, una por hilo, y espera a que acaben todas (el join hace de barrera).
+    // Cada banda solo escribe en sus filas; las filas de arriba y abajo de la banda (el halo) solo se leen.
+    template <class F>
+    void porBandas(int hilos, F trabajo) const
     {
-        posicion.mostrar();
-        cout << " [Grado: " << grado << ", Eliminado: " << (eliminado ? "Sí" : "No") << "]";
+        int porBanda = (filas + hilos - 1) / hilos;
+        vector<thread> trabajadores;
+        for (int b = 0; b < hilos; b++)
+        {
+            int ini = b * porBanda;
+            int fin = min(filas, ini + porBanda);
+            if (ini >= fin)
+                break;
+            trabajadores.emplace_back(trabajo, b, ini, fin);
+        }
+        for (thread &t : trabajadores)
+            t.join();
     }
-};
-
-class GrafoRollos // I asi ja comencen els Grafos complets
-{
-private:
-    map<Posicion, Nodo> nodos;
-    int filas;
-    int columnas;
 
 public:
-    GrafoRollos(int f = 0, int c = 0) : filas(f), columnas(c) {}
+    GrafoRollos(int f = 0, int c = 0) : filas(f), columnas(c), ancho(c + 2), numNodos(0) {}
 
     void setDimensiones(int f, int c)
     {
         filas = f;
         columnas = c;
+        ancho = c + 2;
     }
 
-    void agregarNodo(const Posicion &pos)
-    {
-        if (nodos.find(pos) == nodos.end())
-        {
-            nodos.insert({pos, Nodo(pos)});
-        }
-    }
-
-    Nodo *obtenerNodo(const Posicion &pos)
-    {
-        auto it = nodos.find(pos);
-        return (it != nodos.end()) ? &(it->second) : nullptr;
-    }
-
-    const map<Posicion, Nodo> &getNodos() const
-    {
-        return nodos;
-    }
+    int getNumNodos() const { return numNodos; }
 
-    void construirDesdeMatriz(const vector<string> &matriz)
+    void construirDesdeMatriz(const Rejilla &matriz)
     {
-        filas = matriz.size();
-        columnas = matriz[0].size();
+        filas = matriz.filas();
+        columnas = matriz.columnas();
+        ancho = columnas + 2;
+
+        size_t total = (size_t)(filas + 2) * ancho;
+        esRollo.assign(total, 0);
+        grado.assign(total, 0);
+        eliminado.assign(total, 0);
+        numNodos = 0;
+
+        int k = 0;
+        for (int di = -1; di <= 1; di++) // Mirem a les 8 posicions veïnes
+            for (int dj = -1; dj <= 1; dj++)
+                if (di != 0 || dj != 0)
+                    desplazamientos[k++] = di * ancho + dj;
 
         // Primera pasada: crear todos los nodos
         for (int i = 0; i < filas; i++)
         {
             for (int j = 0; j < columnas; j++)
             {
-                if (matriz[i][j] == '@')
+                if (matriz.at(i, j) == '@')
                 {
-                    Posicion pos(i, j);
-                    agregarNodo(pos);
+                    esRollo[indice(i, j)] = 1;
+                    numNodos++;
                 }
             }
         }
 
+        // Segunda pasada: el grado es cuantos de los 8 vecinos son rollos (el relleno siempre es 0)
         for (int i = 0; i < filas; i++)
         {
             for (int j = 0; j < columnas; j++)
             {
-                if (matriz[i][j] == '@')
-                {
-                    Posicion posActual(i, j);
-                    Nodo *nodoActual = obtenerNodo(posActual);
-
-                    for (int di = -1; di <= 1; di++) // Mirem a les 8 posicions veïnes
-                    {
-                        for (int dj = -1; dj <= 1; dj++)
-                        {
-                            if (di == 0 && dj == 0)
-                                continue;
-                            // Evitar duplicados: solo procesar cuando (di,dj) > (0,0) lexicográficamente
-                            if (di < 0 || (di == 0 && dj < 0))
-                                continue;
-
-                            int ni = i + di;
-                            int nj = j + dj;
-
-                            if (ni >= 0 && ni < filas && nj >= 0 && nj < columnas)
-                            {
-                                if (matriz[ni][nj] == '@')
-                                {
-                                    Posicion posVecino(ni, nj);
-                                    Nodo *nodoVecino = obtenerNodo(posVecino);
-
-                                    // Conectar ambos nodos (grafo no dirigido)
-                                    nodoActual->agregarVecino(posVecino);
-                                    nodoVecino->agregarVecino(posActual);
-                                }
-                            }
-                        }
-                    }
-                }
+                int id = indice(i, j);
+                if (!esRollo[id])
+                    continue;
+                int g = 0;
+                for (int d : desplazamientos)
+                    g += esRollo[id + d];
+                grado[id] = g;
             }
         }
     }
@@ -190,9 +164,9 @@ public:
     int contarAccesiblesIniciales() const
     {
         int contador = 0;
-        for (const auto &par : nodos)
+        for (int id = 0; id < (int)esRollo.size(); id++)
         {
-            if (par.second.esAccesible())
+            if (esAccesible(id))
             {
                 contador++;
             }
@@ -203,41 +177,32 @@ public:
     int eliminarEnCascada()
     {
         int totalEliminados = 0;
-        queue<Posicion> cola;
+        ColaCircular cola(numNodos); // Cada nodo entra como mucho una vez, asi que nunca se llena
 
-        for (const auto &par : nodos)
+        for (int id = 0; id < (int)esRollo.size(); id++)
         {
-            if (par.second.esAccesible())
+            if (esAccesible(id))
             {
-                cola.push(par.first);
+                cola.push(id);
             }
         }
 
-        while (!cola.empty())
+        while (!cola.vacia())
         {
-            Posicion posActual = cola.front();
-            cola.pop();
-
-            Nodo *nodoActual = obtenerNodo(posActual);
-
-            if (nodoActual->estaEliminado() || !nodoActual->esAccesible())
-            {
-                continue;
-            }
-
-            nodoActual->setEliminado(true);
+            int actual = cola.pop();
+            eliminado[actual] = 1;
             totalEliminados++;
 
             // Reducir grado de vecinos
-            for (const Posicion &posVecino : nodoActual->getVecinos())
+            for (int d : desplazamientos)
             {
-                Nodo *vecino = obtenerNodo(posVecino);
-                if (!vecino->estaEliminado())
+                int vecino = actual + d;
+                if (esRollo[vecino] && !eliminado[vecino])
                 {
-                    vecino->reducirGrado();
-                    if (vecino->esAccesible())
+                    grado[vecino]--;
+                    if (grado[vecino] == 3) // Justo ahora pasa a ser accesible: se encola una sola vez
                     {
-                        cola.push(posVecino);
+                        cola.push(vecino);
                     }
                 }
             }
@@ -246,22 +211,91 @@ public:
         return totalEliminados;
     }
 
+    int contarAccesiblesParalelo(int hilos) const // Igual que contarAccesiblesIniciales, una banda de filas por hilo
+    {
+        vector<int> parciales(hilos, 0);
+        porBandas(hilos, [&](int b, int ini, int fin)
+                  {
+            int contador = 0;
+            for (int id = indice(ini, 0); id < indice(fin, 0); id++)
+                contador += esAccesible(id);
+            parciales[b] = contador; });
+
+        int contador = 0;
+        for (int p : parciales)
+            contador += p;
+        return contador;
+    }
+
+    // La cascada en paralelo por rondas sincronas (estilo Jacobi): en cada ronda se marcan a la vez todos los
+    // accesibles y despues cada banda descuenta de sus nodos los vecinos marcados. El orden en que se eliminan
+    // no cambia cuales acaban eliminados, asi que el total es el mismo que el de eliminarEnCascada.
+    int eliminarEnRondasParalelo(int hilos)
+    {
+        vector<uint8_t> marcado(esRollo.size(), 0);
+        vector<int> parciales(hilos, 0);
+        int totalEliminados = 0;
+
+        while (true)
+        {
+            porBandas(hilos, [&](int b, int ini, int fin)
+                      {
+                int contador = 0;
+                for (int id = indice(ini, 0); id < indice(fin, 0); id++)
+                {
+                    marcado[id] = esAccesible(id);
+                    contador += marcado[id];
+                }
+                parciales[b] = contador; });
+
+            int ronda = 0;
+            for (int &p : parciales)
+            {
+                ronda += p;
+                p = 0;
+            }
+            if (ronda == 0)
+                break;
+            totalEliminados += ronda;
+
+            porBandas(hilos, [&](int, int ini, int fin)
+                      {
+                for (int id = indice(ini, 0); id < indice(fin, 0); id++)
+                {
+                    if (!esRollo[id] || eliminado[id])
+                        continue;
+                    if (marcado[id])
+                    {
+                        eliminado[id] = 1;
+                        continue;
+                    }
+                    int quitados = 0;
+                    for (int d : desplazamientos) // Lee marcado del halo, pero solo escribe en su banda
+                        quitados += marcado[id + d];
+                    grado[id] -= quitados;
+                } });
+        }
+        return totalEliminados;
+    }
+
     void mostrarEstado() const
     {
         cout << "=== ESTADO DEL GRAFO ===\n";
-        cout << "Nodos totales: " << nodos.size() << "\n";
+        cout << "Nodos totales: " << numNodos << "\n";
 
         int activos = 0, eliminados = 0, accesibles = 0;
-        for (const auto &par : nodos)
+        for (int id = 0; id < (int)esRollo.size(); id++)
         {
-            if (par.second.estaEliminado())
+            if (!esRollo[id])
+                continue;
+            if (eliminado[id])
             {
                 eliminados++;
             }
             else
             {
                 activos++;
-                if (par.second.esAccesible())
+                if (esAccesible(id))
                 {
                     accesibles++;
                 }
@@ -273,44 +307,43 @@ public:
         cout << "Nodos accesibles: " << accesibles << "\n";
 
         cout << "\nDetalle de nodos:\n";
-        for (const auto &par : nodos)
+        for (int id = 0; id < (int)esRollo.size(); id++)
         {
+            if (!esRollo[id])
+                continue;
             cout << "  ";
-            par.second.mostrar();
-            cout << "\n";
+            posicion(id).mostrar();
+            cout << " [Grado: " << (int)grado[id] << ", Eliminado: " << (eliminado[id] ? "Sí" : "No") << "]\n";
         }
         cout << "======================\n";
     }
 };
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    ifstream archivo("input.txt");
-    if (!archivo.is_open())
+    int hilos = 1;
+    if (argc == 3 && strcmp(argv[1], "--threads") == 0)
     {
-        cerr << "Error: No se pudo abrir el archivo input.txt\n";
-        return 1;
+        hilos = max(1, atoi(argv[2]));
     }
 
-    vector<string> matriz;
-    string linea;
-
-    while (getline(archivo, linea))
+    Rejilla matriz;
+    if (!matriz.abrir("input.txt"))
     {
-        matriz.push_back(linea);
+        cerr << "Error: No se pudo abrir el archivo input.txt\n";
+        return 1;
     }
-    archivo.close();
 
     GrafoRollos grafo;
     grafo.construirDesdeMatriz(matriz);
 
-    int parte1 = grafo.contarAccesiblesIniciales();
+    int parte1 = (hilos > 1) ? grafo.contarAccesiblesParalelo(hilos) : grafo.contarAccesiblesIniciales();
     cout << "Parte 1: " << parte1 << endl;
 
     GrafoRollos grafoParaParte2;
     grafoParaParte2.construirDesdeMatriz(matriz);
 
-    int parte2 = grafoParaParte2.eliminarEnCascada();
+    int parte2 = (hilos > 1) ? grafoParaParte2.eliminarEnRondasParalelo(hilos) : grafoParaParte2.eliminarEnCascada();
     cout << "Parte 2: " << parte2 << endl;
 
     return 0;
@@ -2,17 +2,21 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <thread>
+#include <cstring>
+#include "../Comun/Rejilla.h"
 
 using namespace std;
 
-void contar_candidatos(const vector<vector<char>> &matriz, int *candidatos)
+int contar_banda(const Rejilla &matriz, int ini, int fin) // Soles les files [ini, fin), pero mirant els veins de fora (halo)
 {
+    int candidatos = 0;
     int contador = 0;
-    for (int i = 0; i < (int)matriz.size(); ++i)
+    for (int i = ini; i < fin; ++i)
     {
-        for (int j = 0; j < (int)matriz[i].size(); ++j)
+        for (int j = 0; j < matriz.columnas(); ++j)
         {
-            if (matriz[i][j] != '@')
+            if (matriz.at(i, j) != '@')
                 continue;
             for (int di = -1; di <= 1; ++di)
             {
@@ -20,11 +24,11 @@ void contar_candidatos(const vector<vector<char>> &matriz, int *candidatos)
                 {
                     int fila = i + di;
                     int columna = j + dj;
-                    if (fila < 0 || fila >= (int)matriz.size() || columna < 0 || columna >= (int)matriz[i].size())
+                    if (fila < 0 || fila >= matriz.filas() || columna < 0 || columna >= matriz.columnas())
                         continue;
                     if (di == 0 && dj == 0)
                         continue;
-                    if (matriz[fila][columna] != '@')
+                    if (matriz.at(fila, columna) != '@')
                     {
                         continue;
                     }
@@ -33,39 +37,55 @@ void contar_candidatos(const vector<vector<char>> &matriz, int *candidatos)
             }
             if (contador < 4)
             {
-                ++(*candidatos);
+                ++candidatos;
             }
             contador = 0;
         }
     }
+    return candidatos;
 }
 
-int main(void)
+void contar_candidatos(const Rejilla &matriz, int *candidatos)
 {
-    vector<vector<char>> matriz;
-    int n = 0;
-    int m = 0;
-    int contador = 0;
+    *candidatos += contar_banda(matriz, 0, matriz.filas());
+}
+
+void contar_candidatos_paralelo(const Rejilla &matriz, int *candidatos, int hilos) // Una banda de files per fil
+{
+    int filas = matriz.filas();
+    int por_banda = (filas + hilos - 1) / hilos;
+    vector<int> parciales(hilos, 0);
+    vector<thread> trabajadores;
+    for (int b = 0; b < hilos && b * por_banda < filas; ++b)
+    {
+        int ini = b * por_banda;
+        int fin = min(filas, ini + por_banda);
+        trabajadores.emplace_back([&matriz, &parciales, b, ini, fin]()
+                                  { parciales[b] = contar_banda(matriz, ini, fin); });
+    }
+    for (thread &t : trabajadores)
+        t.join();
+    for (int p : parciales) // Sumats sempre en el mateix ordre
+        *candidatos += p;
+}
+
+int main(int argc, char *argv[])
+{
+    int hilos = 1;
+    if (argc == 3 && strcmp(argv[1], "--threads") == 0)
+        hilos = max(1, atoi(argv[2]));
     int candidatos = 0;
-    ifstream archivo("input.txt");
-    string linea;
-    while (getline(archivo, linea))
+    Rejilla matriz; // Mapejada directament, sense copiar fila a fila
+    if (!matriz.abrir("input.txt"))
     {
-        if ((int)matriz.size() <= m)
-        {
-            matriz.push_back(vector<char>(linea.size(), '.'));
-        }
-        for (n = 0; n < (int)linea.size(); ++n)
-        {
-            if (linea[n] != '@')
-                continue;
-            matriz[m][n] = linea[n];
-        }
-        ++m;
+        cerr << "Error: No se pudo abrir el archivo input.txt\n";
+        return 1;
     }
-    archivo.close();
 
-    contar_candidatos(matriz, &candidatos);
+    if (hilos > 1)
+        contar_candidatos_paralelo(matriz, &candidatos, hilos);
+    else
+        contar_candidatos(matriz, &candidatos);
 
     cout << candidatos << "\n";
 
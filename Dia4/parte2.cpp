@@ -2,91 +2,105 @@
 #include <vector>
 #include <string>
 #include <fstream>
+#include <cstring>
+#include "../Comun/Rejilla.h"
 
 using namespace std;
 
-void contar_candidatos(vector<vector<char>> &matriz, vector<vector<int>> &Mcandidatos, int *candidatos)
+// Abans es tornava a recorrer tota la matriu en cada ronda fins que no canviava res (rondes x caselles).
+// Ara es conten els veins de cada rotllo una sola volta, i en cada ronda soles es mira al voltant dels
+// que s'acaben de llevar: quan a un vei li baixa el grau de 4 a 3, passa a ser candidat de la ronda seguent.
+// Aixina el cost es proporcional als rotllos llevats, no a l'area per les rondes.
+
+void contar_vecinos(const Rejilla &matriz, vector<int> &grado)
 {
-    int contador = 0;
-    for (int i = 0; i < (int)matriz.size(); ++i)
+    for (int i = 0; i < matriz.filas(); ++i)
     {
-        for (int j = 0; j < (int)matriz[i].size(); ++j)
+        for (int j = 0; j < matriz.columnas(); ++j)
         {
-            if (matriz[i][j] != '@')
+            if (matriz.at(i, j) != '@')
                 continue;
+            int contador = 0;
             for (int di = -1; di <= 1; ++di) // Aso busca en les 8 posiciones adyacents
             {
                 for (int dj = -1; dj <= 1; ++dj)
                 {
                     int fila = i + di;
                     int columna = j + dj;
-                    if (fila < 0 || fila >= (int)matriz.size() || columna < 0 || columna >= (int)matriz[i].size()) // Mira els limits
+                    if (fila < 0 || fila >= matriz.filas() || columna < 0 || columna >= matriz.columnas()) // Mira els limits
                         continue;
                     if (di == 0 && dj == 0) // Esta es la mateixa posicio que la original, aixina que te la botes
                         continue;
-                    if (matriz[fila][columna] != '@') // Si no hi ha un candidat en la posicio adyacente, continua
-                        continue;
-                    ++contador;
+                    if (matriz.at(fila, columna) == '@')
+                        ++contador;
                 }
             }
-            if (contador < 4)
-            {
-                ++(*candidatos);
-                Mcandidatos[i][j] = 1; // Marcar la posicion como candidato
-            }
-            contador = 0;
+            grado[i * matriz.columnas() + j] = contador;
         }
     }
-    for (int i = 0; i < (int)Mcandidatos.size(); ++i) // Aso se fa despues perque si no interferix en la primera pasada
+}
+
+// Torna el total de rotllos llevats; en rondas deixa quants se'n lleven en cada ronda
+int cascada(Rejilla &matriz, vector<int> &grado, vector<int> &rondas)
+{
+    vector<pair<int, int>> frontera, siguiente;
+    for (int i = 0; i < matriz.filas(); ++i)
+        for (int j = 0; j < matriz.columnas(); ++j)
+            if (matriz.at(i, j) == '@' && grado[i * matriz.columnas() + j] < 4)
+                frontera.push_back({i, j});
+
+    int candidatos = 0;
+    while (!frontera.empty())
     {
-        for (int j = 0; j < (int)Mcandidatos[i].size(); ++j)
+        rondas.push_back(frontera.size());
+        candidatos += frontera.size();
+        for (auto &p : frontera) // Primer es lleven tots els de la ronda, com feia la versio de Mcandidatos
+            matriz.at(p.first, p.second) = '.';
+
+        siguiente.clear();
+        for (auto &p : frontera)
         {
-            if (Mcandidatos[i][j] == 1)
+            for (int di = -1; di <= 1; ++di)
             {
-                matriz[i][j] = '.';    // Actualizar la matriz original para marcar los candidatos
-                Mcandidatos[i][j] = 0; // Resetear la posicion en la matriz de candidatos
+                for (int dj = -1; dj <= 1; ++dj)
+                {
+                    int fila = p.first + di;
+                    int columna = p.second + dj;
+                    if (fila < 0 || fila >= matriz.filas() || columna < 0 || columna >= matriz.columnas())
+                        continue;
+                    if (matriz.at(fila, columna) != '@') // Buit o llevat (tambe els d'esta mateixa ronda)
+                        continue;
+                    if (--grado[fila * matriz.columnas() + columna] == 3) // Acaba de passar a ser accesible, soles una volta per casella
+                        siguiente.push_back({fila, columna});
+                }
             }
         }
+        frontera.swap(siguiente);
     }
+    return candidatos;
 }
 
-int main(void)
+int main(int argc, char *argv[])
 {
-    vector<vector<char>> matriz;
-    vector<vector<int>> Mcandidatos; // Matriz para almacenar la posicion de los candidatos, inicializada al principio como vacia (0s)
-    int n = 0;
-    int m = 0;
-    int contador = 0;
-    int candidatos = 0;
-    ifstream archivo("input.txt");
-    string linea;
-    while (getline(archivo, linea))
+    bool mostrar_rondas = (argc == 2 && strcmp(argv[1], "--rondas") == 0);
+    Rejilla matriz; // Mapejada, les modificacions es queden en memoria (no toquen el fitxer)
+    if (!matriz.abrir("input.txt"))
     {
-        if ((int)matriz.size() <= m)
-        {
-            matriz.push_back(vector<char>(linea.size(), '.'));
-            Mcandidatos.push_back(vector<int>(linea.size(), 0));
-        }
-        for (n = 0; n < (int)linea.size(); ++n)
-        {
-            if (linea[n] != '@')
-                continue;
-            matriz[m][n] = linea[n];
-        }
-        ++m;
+        cerr << "Error: No se pudo abrir el archivo input.txt\n";
+        return 1;
     }
-    archivo.close();
-    while (true) // Repetir hasta que no haya mas candidatos
+    vector<int> grado((size_t)matriz.filas() * matriz.columnas(), 0); // Quants veins amb rotllo te cada casella
+
+    contar_vecinos(matriz, grado);
+    vector<int> rondas;
+    int candidatos = cascada(matriz, grado, rondas);
+
+    if (mostrar_rondas)
     {
-        int x = candidatos;
-        contar_candidatos(matriz, Mcandidatos, &candidatos); // Actaliza la variable candidatos si hay mas candidatos
-        if (x == candidatos)
-        {
-            break;
-        } // No se ha actualizado la variable candidatos
+        for (int r = 0; r < (int)rondas.size(); ++r)
+            cout << "Ronda " << (r + 1) << ": " << rondas[r] << "\n";
     }
-
     cout << candidatos << "\n";
 
     return 0;
-}
\ No newline at end of file
+}
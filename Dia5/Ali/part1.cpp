@@ -1,6 +1,11 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstdint>
+#include "../../Comun/Arena.h"
 
 #define ull unsigned long long
 #define fresh true
@@ -24,21 +29,26 @@ public:
     }
 };
 
+// Els nodes els dona l'assignador (Comun/Arena.h): AsignadorNew fa un new/delete per node,
+// ArenaNodos els trau seguits de blocs grans i al destruir la cafeteria se solten tots de colp
+template <template <class> class Asignador = AsignadorNew>
 class Cafeteria
 {
 private:
     Node *raiz;
+    Asignador<Node> asignador;
 public:
     Cafeteria(Node *raiz = nullptr){
         this->raiz = raiz;
     }    
     ~Cafeteria(){
+		if(Asignador<Node>::liberaEnBloque) return; // la arena ho allibera tot en el seu destructor
 		Node* aux = raiz;
 		Node* nextNode;
 		
 		while(aux != nullptr){ 
 			nextNode = aux->next;
-			delete aux;
+			asignador.destruir(aux);
 			aux = nextNode;
 		}
     }
@@ -55,21 +65,70 @@ public:
     }
 
 	void insert(ull desde,ull hasta) {
-		Node* aux = new Node(desde, hasta, raiz); 
+		Node* aux = asignador.crear(desde, hasta, raiz); 
 	    raiz = aux;
 	}
+
+    // Mode per lots (--lote): en lloc de recorrer la llista per cada id (O(rangs x ids)), es trauen els
+    // rangs a un vector, s'ordenen i s'ajunten; els ids s'ordenen en radix sort (un byte per passada,
+    // guardant la seua posicio original) i es recorren els dos a la vegada en una sola passada.
+    // Torna quants son frescos i, si es demana, deixa en mapa un bit per id (en l'orde original).
+    ull contarLote(const vector<ull> &ids, vector<uint64_t> *mapa = nullptr){
+        vector<pair<ull, ull>> rangos;
+        for (Node *aux = raiz; aux != nullptr; aux = aux->next) {rangos.push_back({aux->desde, aux->hasta});}
+        std::sort(rangos.begin(), rangos.end());
+        vector<pair<ull, ull>> units;
+        for (auto &r : rangos){
+            if (!units.empty() && r.first <= units.back().second) {units.back().second = max(units.back().second, r.second);}
+            else {units.push_back(r);}
+        }
+
+        size_t m = ids.size();
+        vector<pair<ull, uint32_t>> orden(m), aux(m); // (id, posicio original)
+        for (size_t i = 0; i < m; i++) {orden[i] = {ids[i], (uint32_t)i};}
+        for (int desp = 0; desp < 64; desp += 8)
+        {
+            size_t cuenta[257] = {0};
+            for (auto &q : orden) {cuenta[((q.first >> desp) & 0xFF) + 1]++;}
+            if (m > 0 && cuenta[((orden[0].first >> desp) & 0xFF) + 1] == m) {continue;} // tots el mateix byte
+            for (int b = 0; b < 256; b++) {cuenta[b + 1] += cuenta[b];}
+            for (auto &q : orden) {aux[cuenta[(q.first >> desp) & 0xFF]++] = q;}
+            orden.swap(aux);
+        }
+
+        if (mapa) {mapa->assign((m + 63) / 64, 0);}
+        ull count = 0;
+        size_t j = 0; // primer rang que encara pot contindre l'id actual
+        for (auto &q : orden)
+        {
+            while (j < units.size() && units[j].second < q.first) {j++;}
+            bool esFresc = (j < units.size() && units[j].first <= q.first);
+            count += esFresc;
+            if (mapa && esFresc) {(*mapa)[q.second / 64] |= (uint64_t)1 << (q.second % 64);}
+        }
+        return count;
+    }
 };
 
 
 
 int main(int argc, char const *argv[])
 {
+    bool lote = false;                // --lote: ordenar tots els ids i creuar-los d'una volta amb els rangs
+    const char *rutaMapa = nullptr;   // --mapa fitxer: guardar un bit per id (1 = fresc)
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--lote") == 0) {lote = true;}
+        else if (strcmp(argv[i], "--mapa") == 0 && i + 1 < argc) {lote = true; rutaMapa = argv[++i];}
+    }
+
     ifstream fich("input.txt");
     string l1;
-    int count = 0;
+    ull count = 0;
+    vector<ull> ids;
     
     bool inflexion = false;
-    Cafeteria *cafe = new Cafeteria();
+    Cafeteria<ArenaNodos> *cafe = new Cafeteria<ArenaNodos>();
 
     while (getline(fich, l1))
     {
@@ -80,15 +139,26 @@ int main(int argc, char const *argv[])
             ull hasta = stoull(l1.substr(pos_guion + 1));
             cafe->insert(desde, hasta);
         }
-        else if (inflexion) // part del input on estan els casos
+        else if (inflexion && !l1.empty()) // part del input on estan els casos
         {
-            count += (cafe->search(l1) == true) ? 1 : 0;
+            if (lote) {ids.push_back(stoull(l1));}
+            else {count += (cafe->search(l1) == true) ? 1 : 0;}
         }
         else if(l1.empty()) // estem en la linea de antes dels inputs de casos
         {
             inflexion = true;
         }
     }
+    if (lote)
+    {
+        vector<uint64_t> mapa;
+        count = cafe->contarLote(ids, rutaMapa ? &mapa : nullptr);
+        if (rutaMapa)
+        {
+            ofstream eixida(rutaMapa, ios::binary);
+            eixida.write((const char *)mapa.data(), mapa.size() * sizeof(uint64_t));
+        }
+    }
     delete cafe;
     cout << count << endl;
     fich.close();
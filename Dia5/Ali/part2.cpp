@@ -1,6 +1,11 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <vector>
+#include "../../Comun/Arena.h"
 
 #define ull unsigned long long
 
@@ -19,53 +24,96 @@ public:
     }
 };
 
+// Els nodes els dona l'assignador (Comun/Arena.h): AsignadorNew fa un new/delete per node,
+// ArenaNodos els trau seguits de blocs grans i al destruir la cafeteria se solten tots de colp
+template <template <class> class Asignador = AsignadorNew>
 class Cafeteria
 {
 private:
     Node *raiz;
+    Asignador<Node> asignador;
+
+    static Node *fusionar(Node *a, Node *b) // fusiona dos llistes ordenades (a te els d'abans)
+    {
+        Node cap(0, 0);
+        Node *cola = &cap;
+        while (a != nullptr && b != nullptr)
+        {
+            if (b->desde < a->desde){ cola->next = b; b = b->next; }
+            else{ cola->next = a; a = a->next; }
+            cola = cola->next;
+        }
+        cola->next = (a != nullptr) ? a : b;
+        return cap.next;
+    }
+
 public:
     Cafeteria(Node *raiz = nullptr){
         this->raiz = raiz;
     }    
     ~Cafeteria(){
+		if(Asignador<Node>::liberaEnBloque) return; // la arena ho allibera tot en el seu destructor
 		Node* aux = raiz;
 		Node* nextNode;
 		
 		while(aux != nullptr){ 
 			nextNode = aux->next;
-			delete aux;
+			asignador.destruir(aux);
 			aux = nextNode;
 		}
     }
 
 	void insert(ull desde,ull hasta) {
-		Node* aux = new Node(desde, hasta, raiz); 
+		Node* aux = asignador.crear(desde, hasta, raiz); 
 	    raiz = aux;
 	}
 
-    void sort() // de menor a mayor teniendo en cuenta ull desde
+    // Ordena de menor a mayor per desde. Abans era una bombolla intercanviant els valors (O(n^2));
+    // ara es un merge sort de baix a dalt que nomes reenllaça els nodes: nivel[i] guarda una
+    // llista ja ordenada de 2^i nodes, i cada node nou es va fusionant com qui suma 1 en binari.
+    void sort()
     {
-        bool swapFet = true;
-		while(swapFet){
-            Node *aux = raiz;       
-            swapFet = false;
-
-            while (aux->next != nullptr)
-            {
-                if (aux->desde > aux->next->desde)
-                {
-                    ull temp1 = aux->next->desde;
-                    aux->next->desde = aux->desde;
-                    aux->desde = temp1;
-
-                    ull temp2 = aux->next->hasta;
-                    aux->next->hasta = aux->hasta;
-                    aux->hasta = temp2;
-                    swapFet = true;
-                }
-                aux = aux->next;
+        Node *nivel[64] = {nullptr};
+        while (raiz != nullptr)
+        {
+            Node *n = raiz;
+            raiz = raiz->next;
+            n->next = nullptr;
+            int i = 0;
+            for (; nivel[i] != nullptr; i++){
+                n = fusionar(nivel[i], n); // nivel[i] te els d'abans, aixi es queda estable
+                nivel[i] = nullptr;
             }
-		}
+            nivel[i] = n;
+        }
+        for (int i = 0; i < 64; i++){
+            if (nivel[i] != nullptr) raiz = fusionar(nivel[i], raiz);
+        }
+    }
+
+    // L'alternativa: buidar la llista en un vector contigu, radix sort LSD per desde (un byte per
+    // passada) i tornar a escriure els rangs en els mateixos nodes, ja en orde
+    void sortRadix()
+    {
+        vector<pair<ull, ull>> v, aux;
+        for (Node *n = raiz; n != nullptr; n = n->next) v.push_back({n->desde, n->hasta});
+        aux.resize(v.size());
+
+        for (int desp = 0; desp < 64; desp += 8)
+        {
+            size_t cuenta[257] = {0};
+            for (auto &r : v) cuenta[((r.first >> desp) & 0xFF) + 1]++;
+            if (!v.empty() && cuenta[((v[0].first >> desp) & 0xFF) + 1] == v.size()) continue; // tots el mateix byte
+            for (int b = 0; b < 256; b++) cuenta[b + 1] += cuenta[b];
+            for (auto &r : v) aux[cuenta[(r.first >> desp) & 0xFF]++] = r;
+            v.swap(aux);
+        }
+
+        size_t i = 0;
+        for (Node *n = raiz; n != nullptr; n = n->next, i++){
+            n->desde = v[i].first;
+            n->hasta = v[i].second;
+        }
     }
 
     void mirarRangos(){
@@ -78,7 +126,7 @@ public:
                 aux->hasta = max(aux->hasta, aux->next->hasta);
                 Node *apuntar = aux->next->next;
                 Node *temp = aux->next;
-                delete temp;
+                asignador.destruir(temp);
 
                 aux->next = apuntar;
             }
@@ -103,13 +151,64 @@ public:
 
 
 
+template <template <class> class Asignador>
+void medir(const char *nom, ull n) // construir i destruir la llista amb n rangs
+{
+    mt19937_64 gen(2025);
+    auto t0 = chrono::steady_clock::now();
+    Cafeteria<Asignador> *cafe = new Cafeteria<Asignador>();
+    for (ull i = 0; i < n; i++){
+        ull desde = gen() % 1000000000000000ULL;
+        cafe->insert(desde, desde + gen() % 1000);
+    }
+    auto t1 = chrono::steady_clock::now();
+    delete cafe;
+    auto t2 = chrono::steady_clock::now();
+    cout << nom << ": construir " << chrono::duration<double, milli>(t1 - t0).count() << " ms, destruir "
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms" << endl;
+}
+
+void medirOrden(bool radix, ull n) // ordenar n rangs aleatoris amb un dels dos metodes
+{
+    mt19937_64 gen(2025);
+    Cafeteria<ArenaNodos> *cafe = new Cafeteria<ArenaNodos>();
+    for (ull i = 0; i < n; i++){
+        ull desde = gen() % 1000000000000000ULL;
+        cafe->insert(desde, desde + gen() % 1000);
+    }
+    auto t0 = chrono::steady_clock::now();
+    if (radix) cafe->sortRadix();
+    else cafe->sort();
+    auto t1 = chrono::steady_clock::now();
+    ull count = 0;
+    cafe->mirarRangos();
+    cafe->sumar(count);
+    delete cafe;
+    cout << (radix ? "radix" : "merge") << ": ordenar " << chrono::duration<double, milli>(t1 - t0).count()
+         << " ms (suma " << count << ")" << endl;
+}
+
 int main(int argc, char const *argv[])
 {
+    bool radix = false; // --orden merge|radix
+    for (int i = 1; i + 1 < argc; i++){
+        if (strcmp(argv[i], "--orden") == 0) radix = (strcmp(argv[i + 1], "radix") == 0);
+    }
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) // --bench [N], per defecte 10^7 rangs
+    {
+        ull n = (argc >= 3) ? stoull(argv[2]) : 10000000;
+        medir<AsignadorNew>("new/delete", n);
+        medir<ArenaNodos>("arena     ", n);
+        medirOrden(false, n);
+        medirOrden(true, n);
+        return 0;
+    }
+
     ifstream fich("input.txt");
     string l1;
     ull count = 0;
     
-    Cafeteria *cafe = new Cafeteria();
+    Cafeteria<ArenaNodos> *cafe = new Cafeteria<ArenaNodos>();
 
     while (getline(fich, l1))
     {
@@ -125,7 +224,8 @@ int main(int argc, char const *argv[])
             break;
         }
     }
-    cafe->sort();
+    if (radix) cafe->sortRadix();
+    else cafe->sort();
     cafe->mirarRangos();
     cafe->sumar(count);
 
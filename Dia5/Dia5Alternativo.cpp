@@ -10,6 +10,11 @@
 #include <sstream>
 #include <vector>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <chrono>
+#include "../Comun/Arena.h"
 
 using namespace std;
 
@@ -30,18 +35,37 @@ struct Intervalo
 
 struct ItvTreeNode
 {
-    Intervalo itv;    // Intervalo almacenado en el nodo
-    T max;            // Valor máximo en el subárbol con raíz en este nodo
-    ItvTreeNode *izq; // Hijo izquierdo
-    ItvTreeNode *der; // Hijo derecho
+    Intervalo itv;      // Intervalo almacenado en el nodo
+    T max;              // Valor máximo en el subárbol con raíz en este nodo
+    ll suma;            // Longitud cubierta por todos los intervalos del subárbol
+    unsigned prioridad; // Prioridad aleatoria del treap: cada padre tiene mas prioridad que sus hijos
+    ItvTreeNode *izq;   // Hijo izquierdo
+    ItvTreeNode *der;   // Hijo derecho
 
-    ItvTreeNode(const Intervalo &i) : itv(i), max(i.sup), izq(nullptr), der(nullptr) {} // Constructor del nodo
+    ItvTreeNode(const Intervalo &i, unsigned p) : itv(i), max(i.sup), suma(i.rango()), prioridad(p), izq(nullptr), der(nullptr) {} // Constructor del nodo
 };
 
+// El árbol es un treap ordenado por 'inf': con prioridades aleatorias queda equilibrado (altura O(log n)
+// esperada) aunque los intervalos lleguen ordenados. Ademas se mantiene siempre fusionado: los intervalos
+// guardados son disjuntos y no adyacentes, y cada insercion se fusiona en el momento con los que toca.
+// Cada nodo guarda la suma de longitudes de su subárbol, asi que la parte 2 es leer la raiz.
+// Los nodos los da el asignador de la plantilla (Comun/Arena.h): con AsignadorNew es un new/delete por nodo,
+// con ArenaNodos salen seguidos de bloques grandes y clear() los suelta todos de golpe sin recorrer el árbol.
+template <template <class> class Asignador = AsignadorNew>
 class ItvTree
 {
 private:
     ItvTreeNode *root; // Nodo raíz del árbol
+    Asignador<ItvTreeNode> asignador;
+    unsigned semilla;  // Generador xorshift para las prioridades (determinista entre ejecuciones)
+
+    unsigned aleatorio()
+    {
+        semilla ^= semilla << 13;
+        semilla ^= semilla >> 17;
+        semilla ^= semilla << 5;
+        return (semilla);
+    }
 
     void deleteTree(ItvTreeNode *node) // Para gestionar la memoria del árbol, se usa en el destructor, se llama recursivamente liberando cada nodo.
     {
@@ -49,103 +73,182 @@ private:
         {
             deleteTree(node->izq);
             deleteTree(node->der);
-            delete (node);
+            asignador.destruir(node);
         }
     }
 
-    ItvTreeNode *insert(ItvTreeNode *node, const Intervalo &i) // Inserta un nuevo intervalo en el árbol
+    static ll suma(ItvTreeNode *node)
     {
-        if (!node)
+        return (node ? node->suma : 0);
+    }
+
+    static void actualizar(ItvTreeNode *node) // Recalcula los agregados del nodo a partir de sus hijos
+    {
+        node->suma = node->itv.rango() + suma(node->izq) + suma(node->der);
+        node->max = node->itv.sup;
+        if (node->izq && node->izq->max > node->max)
         {
-            return new ItvTreeNode(i); // Crear un nuevo nodo si el nodo actual es nulo
+            node->max = node->izq->max;
         }
-        if (i.inf < node->itv.inf) // Insertar en el subárbol izquierdo o derecho según el límite inferior
+        if (node->der && node->der->max > node->max)
         {
-            node->izq = insert(node->izq, i);
+            node->max = node->der->max;
         }
-        else
+    }
+
+    // Parte el árbol en los nodos con inf < clave (menores) y los de inf >= clave (mayores)
+    static void split(ItvTreeNode *node, T clave, ItvTreeNode *&menores, ItvTreeNode *&mayores)
+    {
+        if (!node)
+        {
+            menores = mayores = nullptr;
+            return;
+        }
+        if (node->itv.inf < clave)
         {
-            node->der = insert(node->der, i);
+            split(node->der, clave, node->der, mayores);
+            menores = node;
         }
-        if (node->max < i.sup) // Actualizar el valor máximo del nodo
+        else
         {
-            node->max = i.sup;
+            split(node->izq, clave, menores, node->izq);
+            mayores = node;
         }
-        return (node);
+        actualizar(node);
     }
-    ItvTreeNode *MergeUtil(ItvTreeNode *node) // Función recursiva para fusionar intervalos que se solapan
+
+    // Une dos árboles donde todo lo de a va antes que todo lo de b
+    static ItvTreeNode *merge(ItvTreeNode *a, ItvTreeNode *b)
     {
-        if (!node) // Caso base
+        if (!a || !b)
         {
-            return (nullptr); // Nodo nulo
+            return (a ? a : b);
         }
-
-        // Fusionar en subárbol izquierdo y derecho (postorden)
-        node->izq = MergeUtil(node->izq);
-        node->der = MergeUtil(node->der);
-
-        // Comprobar si el intervalo actual se solapa con el izquierdo
-        if (node->izq && node->izq->itv.sup >= node->itv.inf - 1)
+        if (a->prioridad > b->prioridad)
         {
-            node->itv.inf = min(node->izq->itv.inf, node->itv.inf);
-            node->itv.sup = max(node->izq->itv.sup, node->itv.sup);
-            ItvTreeNode *temp = node->izq;
-            node->izq = temp->izq;
-            delete (temp);
+            a->der = merge(a->der, b);
+            actualizar(a);
+            return (a);
         }
+        b->izq = merge(a, b->izq);
+        actualizar(b);
+        return (b);
+    }
 
-        // Comprobar si el intervalo actual se solapa con el derecho
-        if (node->der && node->der->itv.inf <= node->itv.sup + 1)
+    // Quita el nodo de mas a la derecha (el de mayor inf) y lo devuelve suelto
+    static ItvTreeNode *sacarUltimo(ItvTreeNode *&node)
+    {
+        if (!node->der)
         {
-            node->itv.inf = min(node->der->itv.inf, node->itv.inf);
-            node->itv.sup = max(node->der->itv.sup, node->itv.sup);
-            ItvTreeNode *temp = node->der;
-            node->der = temp->der;
-            delete (temp);
+            ItvTreeNode *ultimo = node;
+            node = node->izq;
+            ultimo->izq = nullptr;
+            return (ultimo);
         }
+        ItvTreeNode *ultimo = sacarUltimo(node->der);
+        actualizar(node);
+        return (ultimo);
+    }
 
-        return (node);
+    ItvTreeNode *nuevo(const Intervalo &i)
+    {
+        return (asignador.crear(i, aleatorio()));
     }
 
-    ll sumaRec(ItvTreeNode *node) // Función recursiva para calcular la suma de las longitudes de los intervalos
+    void enOrdenRec(ItvTreeNode *node, vector<Intervalo> &salida) const // Recorrido en orden (por limite inferior)
     {
         if (!node)
         {
-            return (0);
+            return;
         }
-        return (node->itv.rango() + sumaRec(node->izq) + sumaRec(node->der)); // Suma la longitud del intervalo actual y las longitudes de los subárboles izquierdo y derecho
+        enOrdenRec(node->izq, salida);
+        salida.push_back(node->itv);
+        enOrdenRec(node->der, salida);
     }
 
 public:
-    ItvTree() : root(nullptr) {}
+    ItvTree() : root(nullptr), semilla(2463534242u) {}
+    ItvTree(const ItvTree &) = delete;
+    ItvTree &operator=(const ItvTree &) = delete;
 
     ~ItvTree() // Destructor para liberar memoria, llama a la función clear, que a su vez llama a deleteTree
     {
         clear();
     }
 
-    void insert(const Intervalo &i) // Funcion publica para insertar un intervalo, llama a la funcion privada
+    void insert(const Intervalo &i) // Inserta un intervalo fusionandolo con todos los que se solapen o sean adyacentes
+    {
+        T inf = i.inf, sup = i.sup;
+        ItvTreeNode *antes, *resto, *medio, *despues;
+        split(root, inf, antes, resto);
+
+        // Antes de 'inf' solo puede tocarle el ultimo (los guardados son disjuntos)
+        if (antes && antes->max >= inf - 1)
+        {
+            ItvTreeNode *ultimo = sacarUltimo(antes);
+            inf = ultimo->itv.inf;
+            sup = std::max(sup, ultimo->itv.sup);
+            asignador.destruir(ultimo);
+        }
+
+        // Todos los que empiezan en [inf, sup + 1] se absorben
+        split(resto, sup + 2, medio, despues);
+        if (medio)
+        {
+            sup = std::max(sup, medio->max);
+            deleteTree(medio);
+        }
+
+        root = merge(merge(antes, nuevo(Intervalo(inf, sup))), despues);
+    }
+
+    void erase(const Intervalo &i) // Quita el rango [i.inf, i.sup], recortando o partiendo los intervalos que lo pisen
     {
-        root = insert(root, i);
+        ItvTreeNode *antes, *resto, *medio, *despues;
+        split(root, i.inf, antes, resto);
+        split(resto, i.sup + 1, medio, despues);
+
+        ItvTreeNode *izquierda = nullptr, *derecha = nullptr; // Trozos que sobreviven a cada lado
+        if (antes && antes->max >= i.inf) // El ultimo de antes puede meterse dentro del rango (o pasarlo entero)
+        {
+            ItvTreeNode *ultimo = sacarUltimo(antes);
+            Intervalo itv = ultimo->itv;
+            asignador.destruir(ultimo);
+            izquierda = nuevo(Intervalo(itv.inf, i.inf - 1));
+            if (itv.sup > i.sup)
+            {
+                derecha = nuevo(Intervalo(i.sup + 1, itv.sup));
+            }
+        }
+        if (medio) // Los que empiezan dentro desaparecen; el ultimo puede dejar un trozo por la derecha
+        {
+            if (medio->max > i.sup)
+            {
+                derecha = nuevo(Intervalo(i.sup + 1, medio->max));
+            }
+            deleteTree(medio);
+        }
+
+        root = merge(merge(antes, izquierda), merge(derecha, despues));
     }
 
-    ItvTreeNode *Merge() // Fusiona los intervalos que se solapen en el árbol, llama a la función privada MergeUtil
+    ItvTreeNode *Merge() // Se mantiene por compatibilidad: el árbol ya se fusiona en cada insercion
     {
-        return (MergeUtil(root));
+        return (root);
     }
 
-    bool inInterval(const T &point) // Comprueba si un punto está dentro de algún intervalo del árbol
+    bool inInterval(const T &point) const // Comprueba si un punto está dentro de algún intervalo del árbol
     {
         ItvTreeNode *current = root; // Empezar desde la raíz
         while (current)
         {
-            if (point >= current->itv.inf && point <= current->itv.sup) // Si el punto está dentro del intervalo actual
+            if (point < current->itv.inf) // Los intervalos son disjuntos: basta con una busqueda binaria normal
             {
-                return (true); // Decimos que si
+                current = current->izq;
             }
-            if (current->izq && current->izq->max >= point) // Sino, decidimos si ir al hijo izquierdo o derecho
+            else if (point <= current->itv.sup)
             {
-                current = current->izq;
+                return (true);
             }
             else
             {
@@ -155,23 +258,217 @@ public:
         return (false);
     }
 
-    ll sumaInternasItv() // Calcula la suma de las longitudes de todos los intervalos en el árbol, llama a la función privada sumaRec
+    ll sumaInternasItv() const // Suma de las longitudes de todos los intervalos: es el agregado de la raiz, O(1)
+    {
+        return (suma(root));
+    }
+
+    vector<Intervalo> enOrden() const // Devuelve los intervalos ordenados por limite inferior
     {
-        return (sumaRec(root));
+        vector<Intervalo> salida;
+        enOrdenRec(root, salida);
+        return (salida);
     }
 
-    void clear() // Limpia el árbol llamando a deleteTree y establece la raíz a nulo
+    void clear() // Limpia el árbol (con la arena de golpe, si no llamando a deleteTree) y establece la raíz a nulo
     {
-        deleteTree(root);
+        if (Asignador<ItvTreeNode>::liberaEnBloque)
+        {
+            asignador.liberarTodo();
+        }
+        else
+        {
+            deleteTree(root);
+        }
         root = nullptr;
     }
 };
 
-int main(void)
+// Para las consultas de la parte 1 no hace falta recorrer el árbol: una vez fusionados, los intervalos se
+// guardan en arrays planos y ordenados, y la búsqueda binaria se hace sobre un array en orden de Eytzinger
+// (el array de un heap: los hijos de k estan en 2k y 2k+1). Asi los primeros niveles de la busqueda quedan
+// juntos en cache, el bucle no tiene ifs y se puede pedir por adelantado la memoria de los siguientes niveles.
+class ConjuntoIntervalos
 {
-    ItvTree tree;              // Instancia del árbol de intervalos
+private:
+    vector<T> inf;       // Limites inferiores ordenados (intervalos ya fusionados y disjuntos)
+    vector<T> sup;       // Limites superiores, en el mismo orden
+    vector<T> eytInf;    // inf en orden de Eytzinger, empezando en 1
+    vector<int> eytPos;  // Para cada posicion de eytInf, su posicion en inf/sup
+    int n;
+
+    void construirEytzinger(int &i, int k) // Recorrido en orden del "heap" implicito, rellenando con los ordenados
+    {
+        if (k <= n)
+        {
+            construirEytzinger(i, 2 * k);
+            eytInf[k] = inf[i];
+            eytPos[k] = i;
+            i++;
+            construirEytzinger(i, 2 * k + 1);
+        }
+    }
+
+public:
+    ConjuntoIntervalos(const vector<Intervalo> &ordenados) // Los intervalos tienen que venir ordenados por inf
+    {
+        for (const Intervalo &itv : ordenados) // Fusionar solapados y adyacentes
+        {
+            if (!inf.empty() && itv.inf <= sup.back() + 1)
+            {
+                sup.back() = max(sup.back(), itv.sup);
+            }
+            else
+            {
+                inf.push_back(itv.inf);
+                sup.push_back(itv.sup);
+            }
+        }
+        n = inf.size();
+        eytInf.assign(n + 1, 0);
+        eytPos.assign(n + 1, n); // eytPos[0] = n: "ninguno es mayor", se usa cuando la busqueda se sale por la derecha
+        int i = 0;
+        construirEytzinger(i, 1);
+    }
+
+    bool inInterval(const T &point) const
+    {
+        // Buscar el primer intervalo con inf > point; el anterior es el unico que puede contener a point
+        int k = 1;
+        while (k <= n)
+        {
+            __builtin_prefetch(eytInf.data() + 16 * k); // Cuatro niveles mas abajo
+            k = 2 * k + (eytInf[k] <= point);           // Sin if: el compilador lo deja en una suma
+        }
+        k >>= __builtin_ffs(~k); // Deshacer los ultimos pasos a la derecha para volver al nodo encontrado
+        int pos = eytPos[k] - 1; // Posicion del ultimo intervalo con inf <= point
+        return (pos >= 0 && point <= sup[pos]);
+    }
+
+    int size() const
+    {
+        return (n);
+    }
+
+    // Modo por lotes: con millones de consultas sale mas a cuenta ordenarlas (radix sort) y recorrerlas a la
+    // vez que los intervalos, en una sola pasada lineal. Devuelve cuantas son frescas y, si se pide, deja en
+    // 'mapa' un bit por consulta (en el orden original) que dice si es fresca.
+    long long contarLote(const vector<T> &consultas, vector<uint64_t> *mapa = nullptr) const
+    {
+        size_t m = consultas.size();
+        vector<pair<uint64_t, uint32_t>> orden(m), aux(m); // (clave, posicion original)
+        for (size_t i = 0; i < m; i++)
+        {
+            // Cambiar el bit de signo para que los negativos queden delante al ordenar como sin signo
+            orden[i] = {(uint64_t)consultas[i] ^ ((uint64_t)1 << 63), (uint32_t)i};
+        }
+
+        for (int desp = 0; desp < 64; desp += 8) // Radix sort LSD, un byte por pasada
+        {
+            size_t cuenta[257] = {0};
+            for (size_t i = 0; i < m; i++)
+            {
+                cuenta[((orden[i].first >> desp) & 0xFF) + 1]++;
+            }
+            if (m > 0 && cuenta[((orden[0].first >> desp) & 0xFF) + 1] == m) // Todas tienen el mismo byte: nada que hacer
+            {
+                continue;
+            }
+            for (int b = 0; b < 256; b++)
+            {
+                cuenta[b + 1] += cuenta[b];
+            }
+            for (size_t i = 0; i < m; i++)
+            {
+                aux[cuenta[(orden[i].first >> desp) & 0xFF]++] = orden[i];
+            }
+            orden.swap(aux);
+        }
+
+        if (mapa)
+        {
+            mapa->assign((m + 63) / 64, 0);
+        }
+        long long frescos = 0;
+        int j = 0; // Primer intervalo que todavia puede contener a la consulta actual
+        for (size_t i = 0; i < m; i++)
+        {
+            T punto = (T)(orden[i].first ^ ((uint64_t)1 << 63));
+            while (j < n && sup[j] < punto)
+            {
+                j++;
+            }
+            bool fresco = (j < n && inf[j] <= punto);
+            frescos += fresco;
+            if (mapa && fresco)
+            {
+                (*mapa)[orden[i].second / 64] |= (uint64_t)1 << (orden[i].second % 64);
+            }
+        }
+        return (frescos);
+    }
+};
+
+// Construye y vacia el árbol con los mismos intervalos para comparar los dos asignadores
+template <template <class> class Asignador>
+void medirArbol(const char *nombre, const vector<Intervalo> &intervalos)
+{
+    ItvTree<Asignador> tree;
+    auto t0 = chrono::steady_clock::now();
+    for (const Intervalo &itv : intervalos)
+    {
+        tree.insert(itv);
+    }
+    auto t1 = chrono::steady_clock::now();
+    ll suma = tree.sumaInternasItv();
+    tree.clear();
+    auto t2 = chrono::steady_clock::now();
+    cout << nombre << ": construir " << chrono::duration<double, milli>(t1 - t0).count() << " ms, vaciar "
+         << chrono::duration<double, milli>(t2 - t1).count() << " ms (suma " << suma << ")" << endl;
+}
+
+int bench(long n)
+{
+    mt19937_64 gen(2025);
+    vector<Intervalo> intervalos;
+    intervalos.reserve(n);
+    for (long i = 0; i < n; i++)
+    {
+        T inf = gen() % 1000000000000000LL;
+        intervalos.push_back(Intervalo(inf, inf + gen() % 1000));
+    }
+    cout << n << " intervalos aleatorios" << endl;
+    medirArbol<AsignadorNew>("new/delete", intervalos);
+    medirArbol<ArenaNodos>("arena     ", intervalos);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) // --bench [N]: construir y vaciar el árbol con N intervalos (10^7 por defecto)
+    {
+        return bench(argc >= 3 ? atol(argv[2]) : 10000000);
+    }
+
+    bool lote = false;          // --lote: ordenar todas las consultas y cruzarlas de una vez con los intervalos
+    const char *rutaMapa = nullptr; // --mapa fichero: guardar un bit por consulta (1 = fresco)
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--lote") == 0)
+        {
+            lote = true;
+        }
+        else if (strcmp(argv[i], "--mapa") == 0 && i + 1 < argc)
+        {
+            lote = true;
+            rutaMapa = argv[++i];
+        }
+    }
+
+    ItvTree<ArenaNodos> tree;  // Instancia del árbol de intervalos, con los nodos en una arena
     ll minimo, maximo, numero; // Variables para los límites de los intervalos y el número a comprobar
-    int frescos = 0;
+    long long frescos = 0;
+    vector<T> consultas;
 
     char guion;
 
@@ -192,20 +489,36 @@ int main(void)
         }
     }
 
-    tree.Merge(); // Fusiono los intervalos que se solapan
+    tree.Merge(); // Ya no hace nada: los intervalos se fusionan al insertarlos
+    ConjuntoIntervalos conjunto(tree.enOrden()); // Copia plana y ordenada para las consultas
 
     while (getline(archivo, linea)) // Sigo a partir de los numeros
     {
         istringstream ss(linea);
         if (ss >> numero)
         {
-            if (tree.inInterval(numero)) // Compruebo si el número está en algún intervalo
+            if (lote)
+            {
+                consultas.push_back(numero);
+            }
+            else if (conjunto.inInterval(numero)) // Compruebo si el número está en algún intervalo
             {
                 ++frescos; // Si estan, se consideran frescos
             }
         }
     }
     archivo.close();
+
+    if (lote)
+    {
+        vector<uint64_t> mapa;
+        frescos = conjunto.contarLote(consultas, rutaMapa ? &mapa : nullptr);
+        if (rutaMapa)
+        {
+            ofstream salida(rutaMapa, ios::binary);
+            salida.write((const char *)mapa.data(), mapa.size() * sizeof(uint64_t));
+        }
+    }
     ll count = tree.sumaInternasItv(); // Suma de las longitudes de los intervalos
 
     cout << "Cantidad de alimentos aun frescos (parte1): " << frescos << endl;
@@ -0,0 +1,271 @@
+// Snapshot compilado de los rangos de frescura, para no volver a parsear el texto y reconstruir el árbol
+// en cada ejecucion. Hay dos modos:
+//   - compilar: lee la seccion de rangos de input.txt, los ordena, los fusiona y los guarda en binario.
+//   - consultar: mapea el snapshot con mmap (no se copia ni se parsea nada) y contesta las consultas de
+//     input.txt con busqueda binaria sobre el propio mapa. La parte 2 ya viene calculada en la cabecera.
+//
+// Compilar:  g++ -std=c++17 -O2 -o Dia5Snapshot Dia5Snapshot.cpp
+// Snapshot:  ./Dia5Snapshot compilar [input] [snapshot]   (por defecto input.txt y rangos.snap)
+// Consultar: ./Dia5Snapshot [snapshot] [--sin-verificar]   (las consultas salen de input.txt)
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <cstdint>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+typedef long long ll;
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "el snapshot se escribe y se lee tal cual esta en memoria (little-endian)");
+
+// Formato en disco (little-endian):
+//   Cabecera (48 bytes)
+//   int64 rangos[2 * n]   pares (inf, sup) ordenados, fusionados (disjuntos y no adyacentes)
+struct Cabecera
+{
+    char magia[8];     // "AOC5SNP"
+    uint32_t version;
+    uint32_t reservado;
+    uint64_t n;        // Numero de rangos
+    uint64_t cubiertos; // Suma de las longitudes (la parte 2)
+    uint64_t checksum; // De los 2 * n enteros de los rangos
+    uint64_t reservado2;
+};
+
+const char MAGIA[8] = "AOC5SNP";
+const uint32_t VERSION = 1;
+
+uint64_t suma_control(const int64_t *datos, size_t cuantos) // FNV-1a, pero de 8 en 8 bytes
+{
+    uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < cuantos; i++)
+    {
+        h ^= (uint64_t)datos[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+bool leer_fichero(const char *ruta, string &contenido)
+{
+    ifstream archivo(ruta, ios::binary);
+    if (!archivo.is_open())
+        return false;
+    contenido.assign((istreambuf_iterator<char>(archivo)), istreambuf_iterator<char>());
+    return true;
+}
+
+// Donde empiezan las consultas: justo despues de la primera linea vacia
+size_t inicio_consultas(const string &contenido)
+{
+    size_t p = contenido.find("\n\n");
+    size_t q = contenido.find("\n\r\n");
+    p = min(p, q);
+    return (p == string::npos) ? contenido.size() : contenido.find('\n', p + 1) + 1;
+}
+
+int compilar(const char *entrada, const char *ruta)
+{
+    string contenido;
+    if (!leer_fichero(entrada, contenido))
+    {
+        cerr << "Error al abrir el archivo " << entrada << endl;
+        return 1;
+    }
+
+    vector<pair<ll, ll>> rangos;
+    const char *p = contenido.data();
+    const char *fin = p + inicio_consultas(contenido);
+    while (p < fin)
+    {
+        ll a, b;
+        auto r1 = from_chars(p, fin, a);
+        if (r1.ec != errc() || r1.ptr == fin || *r1.ptr != '-')
+        {
+            p = (r1.ec == errc()) ? r1.ptr + 1 : p + 1; // Lo que no sea un rango se salta
+            continue;
+        }
+        auto r2 = from_chars(r1.ptr + 1, fin, b);
+        if (r2.ec != errc())
+        {
+            p = r1.ptr + 1;
+            continue;
+        }
+        p = r2.ptr;
+        rangos.push_back({a, b});
+    }
+    sort(rangos.begin(), rangos.end());
+
+    vector<int64_t> unidos; // inf, sup, inf, sup...
+    uint64_t cubiertos = 0;
+    for (const auto &r : rangos)
+    {
+        if (!unidos.empty() && r.first <= unidos.back() + 1)
+            unidos.back() = max<int64_t>(unidos.back(), r.second);
+        else
+        {
+            unidos.push_back(r.first);
+            unidos.push_back(r.second);
+        }
+    }
+    for (size_t i = 0; i < unidos.size(); i += 2)
+        cubiertos += unidos[i + 1] - unidos[i] + 1;
+
+    Cabecera cab;
+    memset(&cab, 0, sizeof(cab));
+    memcpy(cab.magia, MAGIA, sizeof(MAGIA));
+    cab.version = VERSION;
+    cab.n = unidos.size() / 2;
+    cab.cubiertos = cubiertos;
+    cab.checksum = suma_control(unidos.data(), unidos.size());
+
+    ofstream salida(ruta, ios::binary);
+    if (!salida.is_open())
+    {
+        cerr << "No se pudo crear " << ruta << endl;
+        return 1;
+    }
+    salida.write((const char *)&cab, sizeof(cab));
+    salida.write((const char *)unidos.data(), unidos.size() * sizeof(int64_t));
+    if (!salida)
+    {
+        cerr << "Error escribiendo " << ruta << endl;
+        return 1;
+    }
+    cout << rangos.size() << " rangos (" << cab.n << " tras fusionar) escritos en " << ruta << endl;
+    return 0;
+}
+
+class Snapshot // Se mapea el fichero y se consulta directamente, sin copiar nada
+{
+private:
+    int fd = -1;
+    void *mapa = nullptr;
+    size_t tam = 0;
+    const Cabecera *cab = nullptr;
+    const int64_t *rangos = nullptr;
+
+public:
+    ~Snapshot()
+    {
+        if (mapa)
+            munmap(mapa, tam);
+        if (fd >= 0)
+            close(fd);
+    }
+
+    bool abrir(const char *ruta, bool verificar)
+    {
+        fd = open(ruta, O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(Cabecera))
+            return false;
+        tam = st.st_size;
+        mapa = mmap(nullptr, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED)
+        {
+            mapa = nullptr;
+            return false;
+        }
+
+        cab = (const Cabecera *)mapa;
+        if (memcmp(cab->magia, MAGIA, sizeof(MAGIA)) != 0 || cab->version != VERSION)
+            return false;
+        if (tam != sizeof(Cabecera) + 2 * cab->n * sizeof(int64_t)) // Fichero truncado o de otro formato
+            return false;
+        rangos = (const int64_t *)((const char *)mapa + sizeof(Cabecera));
+        return !verificar || suma_control(rangos, 2 * cab->n) == cab->checksum;
+    }
+
+    uint64_t cubiertos() const
+    {
+        return cab->cubiertos;
+    }
+
+    size_t size() const
+    {
+        return cab->n;
+    }
+
+    bool fresco(ll x) const // Busqueda binaria del ultimo rango con inf <= x
+    {
+        size_t base = 0, n = cab->n;
+        if (n == 0)
+            return false;
+        while (n > 1) // Sin ifs dentro: siempre se parte a la mitad y el compilador lo deja en un cmov
+        {
+            size_t mitad = n / 2;
+            base = (rangos[2 * (base + mitad)] <= x) ? base + mitad : base;
+            n -= mitad;
+        }
+        return rangos[2 * base] <= x && x <= rangos[2 * base + 1];
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "compilar") == 0)
+    {
+        const char *entrada = (argc >= 3) ? argv[2] : "input.txt";
+        const char *ruta = (argc >= 4) ? argv[3] : "rangos.snap";
+        return compilar(entrada, ruta);
+    }
+
+    const char *ruta = "rangos.snap";
+    bool verificar = true; // --sin-verificar: no recalcular el checksum al cargar (carga O(1))
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--sin-verificar") == 0)
+            verificar = false;
+        else
+            ruta = argv[i];
+    }
+
+    auto t0 = chrono::steady_clock::now();
+    Snapshot snap;
+    if (!snap.abrir(ruta, verificar))
+    {
+        cerr << "No se pudo cargar el snapshot " << ruta << " (crealo con: " << argv[0] << " compilar)" << endl;
+        return 1;
+    }
+    double carga = chrono::duration<double, micro>(chrono::steady_clock::now() - t0).count();
+
+    string contenido;
+    if (!leer_fichero("input.txt", contenido))
+    {
+        cerr << "Error al abrir el archivo." << endl;
+        return 1;
+    }
+    long long frescos = 0;
+    const char *p = contenido.data() + inicio_consultas(contenido);
+    const char *fin = contenido.data() + contenido.size();
+    while (p < fin)
+    {
+        ll x;
+        auto r = from_chars(p, fin, x);
+        if (r.ec != errc())
+        {
+            p++;
+            continue;
+        }
+        p = r.ptr;
+        frescos += snap.fresco(x);
+    }
+
+    cout << "Cantidad de alimentos aun frescos (parte1): " << frescos << endl;
+    cout << "Suma de longitud de intervalos (parte 2): " << snap.cubiertos() << endl;
+    cerr << snap.size() << " rangos cargados en " << carga << " us" << endl;
+    return 0;
+}
@@ -5,43 +5,122 @@
 #include <fstream>
 #include <sstream>
 #include <vector>
-#include <random>
+#include <array>
+#include <thread>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 
 using namespace std;
 
 typedef long long ll;
 
-random_device rd;  // Objeto para generar semillas aleatorias
-mt19937 gen(rd()); // Tret de internet clarament
-
-void quick_sort(vector<pair<ll, ll>> &arr, int izq, int der) // Tindre que implementar aso en un vector de pairs me mata i molt
+// Abans aci hi havia un quick_sort a ma (recursiu, amb un uniform_int_distribution nou en cada crida).
+// Ara es un radix sort LSD sobre la clau de 64 bits (first), un byte per passada, repartit entre fils:
+//   1. Cada fil conta quants n'hi ha de cada byte en el seu tros (histograma propi).
+//   2. Suma prefixa: on comença cada byte de cada fil en l'eixida (primer per byte, despres per fil).
+//   3. Cada fil escampa el seu tros a la seua posicio. Com cada fil respecta l'orde del seu tros i els
+//      trossos van en orde, cada passada es estable, que es el que necessita el LSD.
+void radix_sort(vector<pair<ll, ll>> &arr, int hilos)
 {
-    int i = izq, j = der;
-    ll tmp;
-    uniform_int_distribution<> dis(izq, der);
-    ll pivote = arr[dis(gen)].first;
-    while (i <= j)
+    size_t n = arr.size();
+    vector<pair<ll, ll>> aux(n);
+    vector<size_t> trozo(hilos + 1);
+    for (int t = 0; t <= hilos; t++)
+        trozo[t] = n * t / hilos;
+    vector<array<size_t, 256>> cuenta(hilos);
+    const uint64_t SIGNO = (uint64_t)1 << 63; // Canviar el signe per a que els negatius vagen davant
+
+    for (int desp = 0; desp < 64; desp += 8)
     {
-        while (arr[i].first < pivote)
-            i++;
-        while (arr[j].first > pivote)
-            j--;
-        if (i <= j)
+        auto byte = [&](const pair<ll, ll> &r)
+        { return (((uint64_t)r.first ^ SIGNO) >> desp) & 0xFF; };
+
+        vector<thread> fils;
+        for (int t = 0; t < hilos; t++)
+            fils.emplace_back([&, t]()
+                              {
+                cuenta[t].fill(0);
+                for (size_t i = trozo[t]; i < trozo[t + 1]; i++)
+                    cuenta[t][byte(arr[i])]++; });
+        for (thread &f : fils)
+            f.join();
+
+        size_t total = 0; // Suma prefixa: cuenta[t][b] passa a ser on escriu el fil t el primer del byte b
+        bool tots_iguals = false;
+        for (int b = 0; b < 256; b++)
         {
-            swap(arr[i], arr[j]);
-            i++;
-            j--;
+            size_t del_byte = 0;
+            for (int t = 0; t < hilos; t++)
+            {
+                size_t c = cuenta[t][b];
+                cuenta[t][b] = total + del_byte;
+                del_byte += c;
+            }
+            tots_iguals |= (del_byte == n);
+            total += del_byte;
         }
+        if (tots_iguals) // Tots tenen el mateix byte: la passada no canviaria res
+            continue;
+
+        fils.clear();
+        for (int t = 0; t < hilos; t++)
+            fils.emplace_back([&, t]()
+                              {
+                for (size_t i = trozo[t]; i < trozo[t + 1]; i++)
+                    aux[cuenta[t][byte(arr[i])]++] = arr[i]; });
+        for (thread &f : fils)
+            f.join();
+        arr.swap(aux);
     }
+}
 
-    if (izq < j)
-        quick_sort(arr, izq, j);
-    if (i < der)
-        quick_sort(arr, i, der);
+// Unio dels rangs ja ordenats, tambe en paralel (reduccio per segments): cada fil ajunta els del seu tros
+// per separat, i despres es cusen els trossos en orde. Al cosir nomes cal mirar les vores, perque dins de
+// cada tros ja no es solapa res; un rang molt llarg pot menjar-se sencers els trossos seguents.
+vector<pair<ll, ll>> unir_rangos(const vector<pair<ll, ll>> &rangos, int hilos)
+{
+    size_t n = rangos.size();
+    vector<vector<pair<ll, ll>>> parcial(hilos);
+    vector<thread> fils;
+    for (int t = 0; t < hilos; t++)
+        fils.emplace_back([&, t]()
+                          {
+            size_t ini = n * t / hilos, fin = n * (t + 1) / hilos;
+            vector<pair<ll, ll>> &unidos = parcial[t];
+            for (size_t i = ini; i < fin; ++i)
+            {
+                const auto &r = rangos[i];
+                if (!unidos.empty() && r.first <= unidos.back().second + 1)
+                    unidos.back().second = max(unidos.back().second, r.second);
+                else
+                    unidos.push_back(r);
+            } });
+    for (thread &f : fils)
+        f.join();
+
+    vector<pair<ll, ll>> rangos_unidos;
+    for (int t = 0; t < hilos; t++)
+    {
+        for (const auto &r : parcial[t])
+        {
+            if (!rangos_unidos.empty() && r.first <= rangos_unidos.back().second + 1)
+                rangos_unidos.back().second = max(rangos_unidos.back().second, r.second);
+            else
+                rangos_unidos.push_back(r);
+        }
+    }
+    return rangos_unidos;
 }
 
-int main(void)
+int main(int argc, char *argv[])
 {
+    int hilos = max(1u, thread::hardware_concurrency());
+    for (int i = 1; i + 1 < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0)
+            hilos = max(1, atoi(argv[i + 1]));
+    }
     ll minimo, maximo;
     char guion;
     string linea;
@@ -65,29 +144,9 @@ int main(void)
         rangos.push_back({minimo, maximo});
     }
     archivo.close();
-    quick_sort(rangos, 0, rangos.size() - 1);
-
-    vector<pair<ll, ll>> rangos_unidos;
-    if (!rangos.empty())
-    {
-        ll inicio = rangos[0].first;
-        ll fin = rangos[0].second;
-        for (int i = 1; i < rangos.size(); ++i)
-        {
-            const auto &r = rangos[i];
-            if (r.first <= fin + 1)
-            {
-                fin = max(fin, r.second);
-            }
-            else
-            {
-                rangos_unidos.push_back({inicio, fin});
-                inicio = r.first;
-                fin = r.second;
-            }
-        }
-        rangos_unidos.push_back({inicio, fin});
-    }
+    hilos = (int)max<size_t>(1, min<size_t>(hilos, rangos.size() / 4096)); // Per a pocs rangs no val la pena obrir fils
+    radix_sort(rangos, hilos);
+    vector<pair<ll, ll>> rangos_unidos = unir_rangos(rangos, hilos);
     for (const auto &r : rangos_unidos)
     {
         frescos += (r.second - r.first + 1);
@@ -1,142 +1,116 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <vector>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include "../../Comun/Entero.h"
 
 #define ull unsigned long long
 
 using namespace std;
 
-class Node
+// Abans era una llista enllaçada de nodes amb data1..data4 (quatre files fixes) i cada insert
+// recorria la llista des de raiz (O(n^2)). Ara es guarda per columnes: files[f][p] es el numero
+// de la fila f en el problema p, aixi que n'hi pot haver les files que siguen i afegir es O(1).
+class Basura
 {
+private:
+    vector<vector<ull>> files; // una per fila d'operands
+    string operadors;          // un per problema
 public:
-    Node *next;
-    ull data1;
-    ull data2;
-    ull data3;
-    ull data4;
-
-    Node(ull data, int flag, Node *next = nullptr){
-        this->data1 = 0;
-        this->data2 = 0;
-        this->data3 = 0;
-        this->data4 = 0;
-        
-        switch (flag)
+    void afegirLinia(const string &l){ // els numeros es llegixen directament, sense stoull
+        vector<ull> fila;
+        size_t i = 0, n = l.size();
+        while (i < n)
         {
-        case 1:
-            this->data1 = data;
-            break;
-        case 2:
-            this->data2 = data;
-            break;
-        case 3:
-            this->data3 = data;
-            break;
-        case 4:
-            this->data4 = data;
-            break;
-        default:
-            break;
+            if (l[i] >= '0' && l[i] <= '9'){
+                ull v = 0;
+                size_t inici = i;
+                while (i < n && l[i] >= '0' && l[i] <= '9')
+                {
+                    // comprovat, com el stoull d'abans: un operand que no cap en 64 bits es un error, no un numero donat la volta
+                    if (__builtin_mul_overflow(v, 10ULL, &v) || __builtin_add_overflow(v, (ull)(l[i] - '0'), &v)) {
+                        size_t fi = l.find_first_not_of("0123456789", i);
+                        throw runtime_error("Numero massa gran: " + l.substr(inici, fi == string::npos ? string::npos : fi - inici));
+                    }
+                    i++;
+                }
+                fila.push_back(v);
+            }
+            else {
+                if (l[i] == '+' || l[i] == '*') {operadors += l[i];}
+                i++;
+            }
         }
-        this->next = nullptr;
+        if (!fila.empty()) {files.push_back(move(fila));}
     }
-};
 
-class Basura
-{
-private:
-    Node *raiz;
-public:
-    Basura(Node *raiz = nullptr){
-        this->raiz = raiz;
-    }    
-    ~Basura(){
-		Node* aux = raiz;
-		Node* nextNode;
-		
-		while(aux != nullptr){ 
-			nextNode = aux->next;
-			delete aux;
-			aux = nextNode;
-		}
-    }
-    void rellenar(ull &data, int flag, Node *&aux){
-        if (aux == nullptr) {return;}
-        
-        if (flag == 2) {aux->data2 = data;}
-        else if (flag == 3) {aux->data3 = data;}
-        else if (flag == 4) {aux->data4 = data;}
-        aux = aux->next;
-    }
-	void insert(ull data, int &flag) {
-        if (raiz == nullptr) {
-            Node* aux = new Node(data, flag, raiz); 
-            raiz = aux; 
-        }
-        else {
-            Node* aux = raiz; 
-            Node* prev = nullptr;
-            while (aux != nullptr)
+    Entero sumData(){ // comprovat: si no cap en 64 bits puja a 128 o a enter gran
+        Entero count;
+        for (size_t p = 0; p < operadors.size(); p++)
+        {
+            bool mult = (operadors[p] == '*');
+            Entero sumaData = mult ? 1 : 0;
+            for (const vector<ull> &fila : files)
             {
-                prev = aux;
-                aux = aux -> next;
+                if (p >= fila.size()) {continue;}
+                if (mult) {sumaData *= fila[p];}
+                else {sumaData += fila[p];}
             }
-            prev->next = new Node(data, flag, aux); 
+            count += sumaData;
         }
-	}
-    void sumData(string operador, ull &count, Node* &aux){
-        if (aux == nullptr) {return;}
-
-        ull sumaData;
-
-        if (operador == "+") {sumaData = aux->data1 + aux->data2 + aux->data3 + aux->data4;}
-        else if (operador == "*") {sumaData = aux->data1 * aux->data2 * aux->data3 * aux->data4;}
-
-        count += sumaData;
-        aux = aux->next;
-    }
-
-    Node* getRaiz(){
-        return raiz;
+        return count;
     }
 };
 
-
+void generar(ull problemes, int nfiles, vector<string> &linies) // full aleatori per al bench
+{
+    mt19937 gen(2025);
+    linies.assign(nfiles + 1, "");
+    for (ull p = 0; p < problemes; p++)
+    {
+        int ample = 1 + gen() % 4;
+        for (int f = 0; f < nfiles; f++)
+        {
+            string num = to_string(1 + gen() % 9999).substr(0, ample);
+            string farcit(ample - num.size(), ' ');
+            linies[f] += (gen() % 2) ? num + farcit : farcit + num;
+            linies[f] += ' ';
+        }
+        linies[nfiles] += (gen() % 2) ? '+' : '*';
+        linies[nfiles] += string(ample, ' ');
+    }
+}
 
 int main(int argc, char const *argv[])
 {
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) // --bench [N]: full de N problemes (10^6 per defecte)
+    {
+        ull n = (argc >= 3) ? stoull(argv[2]) : 1000000;
+        vector<string> linies;
+        generar(n, 4, linies);
+        auto t0 = chrono::steady_clock::now();
+        Basura garbage;
+        for (const string &l : linies) {garbage.afegirLinia(l);}
+        Entero count = garbage.sumData();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << n << " problemes en " << ms << " ms (" << count << ")" << endl;
+        return 0;
+    }
+
     ifstream fich("input.txt");
     string l1;
-    ull count = 0;
-    int flag = 1;
 
-    Basura *garbage = new Basura();
+    Basura garbage;
     while (getline(fich, l1))
     {
-        istringstream ss (l1);
-        string aux;
-        Node *first = garbage->getRaiz();
-        Node *pa_operador = garbage->getRaiz();
-
-        while(ss >> aux){ // segons gpt aso ignora espais en blanc, prou util
-            if (flag == 1) {
-                ull data = stoull(aux);
-                garbage->insert(data, flag);
-            }
-            else if(flag < 5) {
-                ull data = stoull(aux);
-                garbage->rellenar(data, flag, first); // tinc q trobar la forma de diferenciar entre els seguents numeros
-            }
-            else {
-                garbage->sumData(aux, count, pa_operador);
-            }
-        }
-        flag += 1;
+        garbage.afegirLinia(l1);
     }
 
-    delete garbage;
-    cout << count << endl;
+    cout << garbage.sumData() << endl;
     fich.close();
 
     return 0;
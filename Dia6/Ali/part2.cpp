@@ -1,171 +1,122 @@
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <sstream>
+#include <vector>
+#include <cstring>
+#include <chrono>
+#include <random>
+#include "../../Comun/Entero.h"
 
 #define ull unsigned long long
 
 using namespace std;
 
-class Node
-{
-public:
-    Node *next;
-    ull data1;
-    ull data2;
-    ull data3;
-    ull data4;
-
-    Node(ull data, int flag, Node *next = nullptr){
-        this->data1 = 0;
-        this->data2 = 0;
-        this->data3 = 0;
-        this->data4 = 0;
-        
-        switch (flag) {
-        case 1:
-            this->data1 = data;
-            break;
-        case 2:
-            this->data2 = data;
-            break;
-        case 3:
-            this->data3 = data;
-            break;
-        case 4:
-            this->data4 = data;
-            break;
-        default:
-            break;
-        }
-        this->next = nullptr;
-    }
-};
-
+// Abans era una llista enllaçada amb data1..data4 (quatre files fixes), cada insert recorria la llista
+// (O(n^2)) i els numeros de columna es feien amb to_string + stoull suposant que tots anaven alineats a la
+// dreta. Ara es guarda una matriu de digits tal com estan en el full (digits[f][c], -1 si no hi ha digit)
+// i la linia d'operadors. Per a cada columna el numero es fa de dalt a baix amb num = num * 10 + digit;
+// els problemes son els trams entre columnes buides. Tot es O(mida del full), amb les files que siguen.
 class Basura
 {
 private:
-    Node *raiz;
+    vector<vector<signed char>> digits; // una fila per cada linia d'operands
+    string operadors;                   // la linia dels + i *
+    size_t ample = 0;
+
+    signed char digit(size_t f, size_t c) const {return (c < digits[f].size()) ? digits[f][c] : -1;}
+    char operador(size_t c) const {return (c < operadors.size()) ? operadors[c] : ' ';}
+
 public:
-    Basura(Node *raiz = nullptr){
-        this->raiz = raiz;
-    }    
-    ~Basura(){
-		Node* aux = raiz;
-		Node* nextNode;
-		
-		while(aux != nullptr){ 
-			nextNode = aux->next;
-			delete aux;
-			aux = nextNode;
-		}
-    }
-    void rellenar(ull &data, int flag, Node *&aux){
-        if (aux == nullptr) {return;}
-        
-        if (flag == 2) {aux->data2 = data;}
-        else if (flag == 3) {aux->data3 = data;}
-        else if (flag == 4) {aux->data4 = data;}
-        aux = aux->next;
-    }
-	void insert(ull data, int &flag) {
-        if (raiz == nullptr) {
-            Node* aux = new Node(data, flag, raiz); 
-            raiz = aux; 
-        }
+    void afegirLinia(const string &l){
+        if (l.find_first_of("+*") != string::npos) {operadors = l;} // la ultima, la dels operadors
         else {
-            Node* aux = raiz; 
-            Node* prev = nullptr;
-            while (aux != nullptr)
-            {
-                prev = aux;
-                aux = aux -> next;
-            }
-            prev->next = new Node(data, flag, nullptr); 
+            vector<signed char> fila(l.size());
+            for (size_t c = 0; c < l.size(); c++) {fila[c] = (l[c] >= '0' && l[c] <= '9') ? l[c] - '0' : -1;}
+            digits.push_back(move(fila));
         }
-	}
-    void sumData(string operador, ull &count, Node* &aux){
-        if (aux == nullptr) {return;}
-
-        ull sumaData = 0;
-
-        string unitats = to_string(aux->data1 % 10) + to_string(aux->data2 % 10) + to_string(aux->data3 % 10) + to_string(aux->data4 % 10);
-
-        string decenes = "";
-        decenes += (aux->data1 >= 10) ? to_string((aux->data1 / 10) % 10) : "";
-        decenes += (aux->data2 >= 10) ? to_string((aux->data2 / 10) % 10) : "";
-        decenes += (aux->data3 >= 10) ? to_string((aux->data3 / 10) % 10) : "";
-        decenes += (aux->data4 >= 10) ? to_string((aux->data4 / 10) % 10) : "";
-
-        string centenes = "";
-        centenes += (aux->data1 >= 100) ? to_string((aux->data1 / 100) % 10) : "";
-        centenes += (aux->data2 >= 100) ? to_string((aux->data2 / 100) % 10) : "";
-        centenes += (aux->data3 >= 100) ? to_string((aux->data3 / 100) % 10) : "";
-        centenes += (aux->data4 >= 100) ? to_string((aux->data4 / 100) % 10) : "";
-
-        string milers = "";
-        milers += (aux->data1 >= 1000) ? to_string((aux->data1 / 1000) % 10) : "";
-        milers += (aux->data2 >= 1000) ? to_string((aux->data2 / 1000) % 10) : "";
-        milers += (aux->data3 >= 1000) ? to_string((aux->data3 / 1000) % 10) : "";
-        milers += (aux->data4 >= 1000) ? to_string((aux->data4 / 1000) % 10) : "";
-
-        ull v1 = unitats.empty() ? 0 : stoull(unitats);
-        ull v2 = decenes.empty() ? 0 : stoull(decenes);
-        ull v3 = centenes.empty() ? 0 : stoull(centenes);
-        ull v4 = milers.empty() ? 0 : stoull(milers);
+        ample = max(ample, l.size());
+    }
 
-        if (operador == "+") {
-            sumaData = v1 + v2 + v3 + v4;
-        }
-        else if (operador == "*") {
-            if (v2 == 0 && decenes.empty()) {v2 = 1;}
-            if (v3 == 0 && centenes.empty()) {v3 = 1;}
-            if (v4 == 0 && milers.empty()) {v4 = 1;}
-            
-            sumaData = v1 * v2 * v3 * v4;
+    Entero sumData(){ // comprovat: si no cap en 64 bits puja a 128 o a enter gran
+        Entero count;
+        vector<Entero> numeros; // els de la columna de cada problema
+        char op = ' ';
+        for (size_t c = 0; c <= ample; c++)
+        {
+            Entero num;
+            bool hiHa = false;
+            for (size_t f = 0; f < digits.size(); f++)
+            {
+                signed char d = digit(f, c);
+                if (d >= 0) {num.agregarDigito(d); hiHa = true;}
+            }
+            if (operador(c) != ' ') {op = operador(c);}
+            if (hiHa) {numeros.push_back(num); continue;}
+            if (operador(c) != ' ') {continue;}
+
+            // columna buida (o el final): es tanca el problema
+            if (!numeros.empty() && op != ' ') {
+                Entero sumaData = numeros[0];
+                for (size_t i = 1; i < numeros.size(); i++)
+                {
+                    if (op == '*') {sumaData *= numeros[i];}
+                    else {sumaData += numeros[i];}
+                }
+                count += sumaData;
+            }
+            numeros.clear();
+            op = ' ';
         }
-
-        count += sumaData;
-        aux = aux->next;
+        return count;
     }
+};
 
-    Node* getRaiz(){
-        return raiz;
+void generar(ull problemes, int nfiles, vector<string> &linies) // full aleatori per al bench
+{
+    mt19937 gen(2025);
+    linies.assign(nfiles + 1, "");
+    for (ull p = 0; p < problemes; p++)
+    {
+        int ample = 1 + gen() % 4;
+        for (int f = 0; f < nfiles; f++)
+        {
+            string num = to_string(1 + gen() % 9999).substr(0, ample);
+            string farcit(ample - num.size(), ' ');
+            linies[f] += (gen() % 2) ? num + farcit : farcit + num;
+            linies[f] += ' ';
+        }
+        linies[nfiles] += (gen() % 2) ? '+' : '*';
+        linies[nfiles] += string(ample, ' ');
     }
-};
+}
 
 int main(int argc, char const *argv[])
 {
-    ifstream fich("input.txt"); string l1;
-    ull count = 0; int flag = 1;
-    
-    Basura *garbage = new Basura();
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) // --bench [N]: full de N problemes (10^6 per defecte)
+    {
+        ull n = (argc >= 3) ? stoull(argv[2]) : 1000000;
+        vector<string> linies;
+        generar(n, 4, linies);
+        auto t0 = chrono::steady_clock::now();
+        Basura garbage;
+        for (const string &l : linies) {garbage.afegirLinia(l);}
+        Entero count = garbage.sumData();
+        double ms = chrono::duration<double, milli>(chrono::steady_clock::now() - t0).count();
+        cout << n << " problemes en " << ms << " ms (" << count << ")" << endl;
+        return 0;
+    }
+
+    ifstream fich("input.txt");
+    string l1;
 
+    Basura garbage;
     while (getline(fich, l1))
     {
-        istringstream ss (l1);
-        string aux;
-        Node *first = garbage->getRaiz();
-        Node *paOperador = garbage->getRaiz();
-
-        while(ss >> aux){ 
-            if (flag == 1) { // data1
-                ull data = stoull(aux);
-                garbage->insert(data, flag);
-            }
-            else if(flag < 5) { // data2 3 i 4
-                ull data = stoull(aux);
-                garbage->rellenar(data, flag, first); 
-            }
-            else if(flag == 5){
-                garbage->sumData(aux, count, paOperador);
-            }
-        }
-        flag += 1;
+        if (!l1.empty() && l1.back() == '\r') {l1.pop_back();}
+        garbage.afegirLinia(l1);
     }
 
-    delete garbage;
-    cout << count << endl;
+    cout << garbage.sumData() << endl;
     fich.close();
 
     return 0;
@@ -1,104 +1,252 @@
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
-#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+#include "../Comun/Rejilla.h"
+#include "../Comun/Entero.h"
 
 typedef long long ll;
 using namespace std;
 
-bool es_bacia(vector<string> &lineas, int columna, int num_filas)
+// Abans, per cada columna es recorrien totes les files per a vore si era buida (es_bacia), i cada numero
+// es muntava concatenant chars en un string i fent stoll. Ara es fa en una passada:
+//   1. Mapa de columnes buides: es recorre fila a fila i es fa un AND de (casella == ' ') sobre tota la
+//      fila. El bucle interior va per columnes consecutives, aixina que el compilador el vectoritza.
+//   2. Els blocs (problemes) son els trams entre columnes buides, guardats com a [ini, fin).
+//   3. Dins de cada bloc els digits es sumen directament en un enter (num = num * 10 + digit).
+// Els numeros, els resultats i la suma son Entero (Comun/Entero.h): van en 64 bits mentres caben i, si una
+// columna llarga de '*' es desborda, pugen a 128 bits o a un enter gran en lloc de donar basura.
+
+struct Bloque
 {
-    for (int fila = 0; fila < num_filas; fila++)
+    int ini; // Primera columna del problema
+    int fin; // Una passada l'ultima
+};
+
+vector<uint8_t> columnas_bacias(const Rejilla &lineas)
+{
+    int num_columnas = lineas.columnas();
+    vector<uint8_t> bacia(num_columnas, 1);
+    uint8_t *b = bacia.data();
+    for (int fila = 0; fila < lineas.filas(); fila++)
     {
-        if (lineas[fila][columna] != ' ')
+        const char *f = lineas.filaPtr(fila);
+        for (int c = 0; c < num_columnas; c++)
         {
-            return false;
+            b[c] &= (f[c] == ' ');
         }
     }
-    return true;
+    return bacia;
 }
 
-int main(void)
+vector<Bloque> partir_bloques(const vector<uint8_t> &bacia)
 {
-    ll suma = 0;
-
-    ifstream file("input.txt");
-    string linea;
-    vector<string> lineas;
+    vector<Bloque> bloques;
+    int num_columnas = bacia.size();
+    int col = 0;
+    while (col < num_columnas)
+    {
+        if (bacia[col])
+        {
+            col++;
+            continue;
+        }
+        int ibloque = col;
+        while (col < num_columnas && !bacia[col])
+        {
+            col++;
+        }
+        bloques.push_back({ibloque, col});
+    }
+    return bloques;
+}
 
-    int max_tamaño = -1;
-    while (getline(file, linea))
+// Afig el numero d'una columna al resultat del problema (el primer numero es el valor inicial)
+void acumular(char signo, Entero &resultado, bool &primero, const Entero &num)
+{
+    if (primero)
     {
-        lineas.push_back(linea);
-        max_tamaño = max(max_tamaño, (int)linea.size());
+        resultado = num;
+        primero = false;
+        return;
     }
-    file.close();
+    switch (signo)
+    {
+    case '+':
+        resultado += num;
+        break;
+    case '*':
+        resultado *= num;
+        break;
 
-    for (int i = 0; i < lineas.size(); i++)
+    default:
+        throw runtime_error("Operador desconegut");
+    }
+}
+
+Entero resolver_bloque(const Rejilla &lineas, Bloque bloque)
+{
+    int num_filas = lineas.filas();
+    char signo = lineas.at(num_filas - 1, bloque.ini);
+    Entero resultado;
+    bool primero = true;
+    for (int c = bloque.fin - 1; c >= bloque.ini; c--) // D'esquerra a dreta no, de dreta a esquerra
     {
-        lineas[i].resize(max_tamaño, ' ');
+        Entero num;
+        bool hay_digito = false;
+        for (int fila = 0; fila < (num_filas - 1); fila++)
+        {
+            char digito = lineas.at(fila, c);
+            if (digito >= '0' && digito <= '9')
+            {
+                num.agregarDigito(digito - '0');
+                hay_digito = true;
+            }
+        }
+        if (hay_digito)
+        {
+            acumular(signo, resultado, primero, num);
+        }
     }
-    int num_filas = lineas.size();
-    int num_columnas = max_tamaño;
+    return (primero || signo == ' ') ? Entero(0) : resultado;
+}
 
-    for (int col = 0; col < num_columnas; col++)
+// Mode --streaming, per a fulls de poques files pero de centenars de MB d'ample: en lloc de carregar el full
+// sencer, cada fila te el seu propi cursor (un FILE* amb un buffer xicotet) i totes avancen a la vegada,
+// una columna cada volta. Com + i * no depenen de l'orde, cada numero de columna s'acumula al resultat del
+// problema tan prompte es llig, i el problema se suma al total en vore la columna buida que el tanca.
+// La memoria es la dels buffers de les files, no depen ni de l'ample del full ni del dels problemes.
+const size_t TAM_BUFFER_FILA = 1 << 16;
+
+Entero resolver_streaming(const char *ruta)
+{
+    FILE *f = fopen(ruta, "rb");
+    if (!f)
+    {
+        throw runtime_error("No se pudo abrir el archivo");
+    }
+    // Primera passada: on comença i quant mesura cada fila (llegint a trossos, sense guardar res)
+    vector<long> inicio, longitud;
+    vector<char> trozo(TAM_BUFFER_FILA);
+    long pos = 0, ini_fila = 0;
+    size_t leidos;
+    while ((leidos = fread(trozo.data(), 1, trozo.size(), f)) > 0)
     {
-        if (es_bacia(lineas, col, num_filas))
+        for (const char *p = trozo.data(), *fin = p + leidos; (p = (const char *)memchr(p, '\n', fin - p)) != nullptr; p++)
         {
-            continue;
+            long salto = pos + (p - trozo.data());
+            inicio.push_back(ini_fila);
+            longitud.push_back(salto - ini_fila);
+            ini_fila = salto + 1;
         }
+        pos += leidos;
+    }
+    if (pos > ini_fila) // Ultima fila sense salt de linia
+    {
+        inicio.push_back(ini_fila);
+        longitud.push_back(pos - ini_fila);
+    }
+    fclose(f);
 
-        int ibloque = col;
-        int fbloque = col;
-        while ((fbloque < num_columnas) && (!(es_bacia(lineas, fbloque, num_filas))))
+    int num_filas = inicio.size();
+    Entero suma;
+    if (num_filas == 0)
+    {
+        return suma;
+    }
+    vector<FILE *> cursor(num_filas);
+    long ancho = 0;
+    for (int fila = 0; fila < num_filas; fila++)
+    {
+        cursor[fila] = fopen(ruta, "rb");
+        if (!cursor[fila])
         {
-            ++fbloque;
+            throw runtime_error("No se pudo abrir el archivo");
         }
+        setvbuf(cursor[fila], nullptr, _IOFBF, TAM_BUFFER_FILA);
+        fseek(cursor[fila], inicio[fila], SEEK_SET);
+        ancho = max(ancho, longitud[fila]);
+    }
 
-        vector<ll> numeros;
-        char signo = ' ';
-        for (int c = (fbloque - 1); c >= ibloque; c--)
+    vector<char> columna(num_filas);
+    Entero resultado;
+    bool primero = true, dins = false; // dins: s'esta dins d'un problema
+    char signo = ' ';
+    for (long c = 0; c <= ancho; c++) // La columna 'ancho' fa de buida final per a tancar l'ultim
+    {
+        bool bacia = true;
+        for (int fila = 0; fila < num_filas; fila++)
         {
-            string num = "";
-            for (int fila = 0; fila < (num_filas - 1); fila++)
-            {
-                char digito = lineas[fila][c];
-                if (isdigit(digito))
-                {
-                    num += digito;
-                }
-            }
-            if (!(num.empty()))
-            {
-                numeros.push_back(stoll(num));
-            }
-            if (c == ibloque)
+            char ch = (c < longitud[fila]) ? (char)getc(cursor[fila]) : ' ';
+            columna[fila] = (ch == '\r') ? ' ' : ch;
+            bacia &= (columna[fila] == ' ');
+        }
+        if (bacia)
+        {
+            if (dins && !primero && signo != ' ')
             {
-                signo = lineas[(num_filas - 1)][c];
+                suma += resultado;
             }
+            dins = false;
+            continue;
+        }
+        if (!dins) // Primera columna del problema: ahi esta el signe
+        {
+            dins = true;
+            primero = true;
+            signo = columna[num_filas - 1];
         }
-        if (!(numeros.empty()) && (signo != ' '))
+        Entero num;
+        bool hay_digito = false;
+        for (int fila = 0; fila < (num_filas - 1); fila++)
         {
-            ll resultado = numeros[0];
-            for (int i = 1; i < numeros.size(); i++)
+            if (columna[fila] >= '0' && columna[fila] <= '9')
             {
-                switch (signo)
-                {
-                case '+':
-                    resultado += numeros[i];
-                    break;
-                case '*':
-                    resultado *= numeros[i];
-                    break;
-
-                default:
-                    throw runtime_error("Operador desconegut");
-                }
+                num.agregarDigito(columna[fila] - '0');
+                hay_digito = true;
             }
-            suma += resultado;
         }
-        col = fbloque - 1;
+        if (hay_digito)
+        {
+            acumular(signo, resultado, primero, num);
+        }
+    }
+    for (FILE *cur : cursor)
+    {
+        fclose(cur);
+    }
+    return suma;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "--streaming") == 0) // --streaming [fitxer]
+    {
+        cout << resolver_streaming(argc >= 3 ? argv[2] : "input.txt") << endl;
+        return 0;
+    }
+
+    Entero suma;
+
+    Rejilla lineas; // Les files mes curtes es completen en espais, com feia el resize a max_tamaño
+    if (!lineas.abrir("input.txt", 0, ' '))
+    {
+        cerr << "No se pudo abrir el archivo" << endl;
+        return 1;
+    }
+    int num_filas = lineas.filas();
+    if (num_filas == 0)
+    {
+        cout << suma << endl;
+        return 0;
+    }
+
+    for (const Bloque &bloque : partir_bloques(columnas_bacias(lineas)))
+    {
+        suma += resolver_bloque(lineas, bloque);
     }
     cout << suma << endl;
     return 0;
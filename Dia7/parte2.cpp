@@ -1,71 +1,167 @@
 // Programacio dinamica perque me sentia inspirat i en ganes de complicar-me el dia y la vida
 
 #include <iostream>
-#include <fstream>
 #include <vector>
+#include <algorithm>
 #include <string.h>
+#include <random>
+#include <chrono>
+#include <cstdint>
+#include "../Comun/Rejilla.h"
 
 typedef long long ll;
+typedef uint64_t u64;
 
 using namespace std;
 
 // Cada dia odie mes la programacio, 40 minuts i un dinar despues y me done conter de que el error estaba en que retornava un int
 // en conter de un long long, aixo me limitaba el numero que me retornava y me donava be per a el cas de proba que fiquen en el AoC
 // pero per al input gran no me donava be. Que dur.
-ll posibilidades(const vector<string> &lineas, int fila, int col, vector<vector<ll>> &memo)
+//
+// Abans era recursiu de dalt a baix amb un memo de files x columnes (i el 0 com a "no calculat", aixina que les caselles
+// amb 0 camins es tornaven a calcular). Ara es al reves: es baixa fila a fila portant quants camins arriben a cada columna.
+// Soles fan falta dos files de ll (la actual i la seguent), aixina que ni la pila ni la memoria creixen en les files.
+template <class G>
+ll posibilidades(const G &lineas)
 {
-    if (fila >= lineas.size() - 1) // Cas base: Acabar les files o estar en la ultima fila
+    int columnas = lineas.columnas();
+    vector<ll> actual(columnas, 0), siguiente(columnas, 0);
+    for (int i = 0; i < columnas; i++)
     {
-        return 1;
+        if (lineas.at(0, i) == 'S') // Cuan trobe la columna de inici, comença tot
+        {
+            actual[i] += 1;
+        }
+    }
+    for (int fila = 0; fila + 1 < lineas.filas(); fila++)
+    {
+        fill(siguiente.begin(), siguiente.end(), 0);
+        const char *abajo = lineas.filaPtr(fila + 1);
+        for (int col = 0; col < columnas; col++)
+        {
+            ll caminos = actual[col];
+            if (caminos == 0)
+            {
+                continue;
+            }
+            if (abajo[col] == '^') // Igual que la part 1: es partix a esquerra i dreta (si no s'ix de la rejilla)
+            {
+                if (col - 1 >= 0)
+                {
+                    siguiente[col - 1] += caminos;
+                }
+                if (col + 1 < columnas)
+                {
+                    siguiente[col + 1] += caminos;
+                }
+            }
+            else
+            {
+                siguiente[col] += caminos; // Segueix recte
+            }
+        }
+        actual.swap(siguiente);
     }
-    if (memo[fila][col] != 0) // Cas Base: Per a no recalcular coses que ya tenim
+    ll total = 0;
+    for (ll caminos : actual)
     {
-        return memo[fila][col];
+        total += caminos;
     }
-    if (lineas[fila + 1][col] == '^') // Igual que la part 1, pero ara guardant en memo y fent recursivitat
+    return total;
+}
+
+// La mateixa propagacio pero sense ifs, per a que el compilador la faça en SIMD. Cada fila:
+//   1. Mascara de divisors: 0 o tot uns (~0) per columna, segons si baix hi ha '^' (comparacio de bytes).
+//   2. siguiente[c] = recte + el que li arriba partit des de c-1 i des de c+1:
+//        (actual[c] & ~m[c]) + (actual[c-1] & m[c-1]) + (actual[c+1] & m[c+1])
+// Les files porten una columna de farciment (a 0) a cada costat, aixina que no cal mirar les vores: el que
+// es partix cap a fora cau en el farciment i es perd. Els comptes van en u64 (el desbordament es modular).
+// Compilar amb g++ -std=c++17 -O2 -march=native per a que el bucle isca en AVX2; ./parte2 --bench [ample] [files] el compara.
+template <class G>
+ll posibilidades_vectorial(const G &lineas)
+{
+    int columnas = lineas.columnas();
+    vector<u64> actual(columnas + 2, 0), siguiente(columnas + 2, 0), mascara(columnas + 2, 0);
+    const char *primera = lineas.filaPtr(0);
+    for (int c = 0; c < columnas; c++)
     {
-        if (col - 1 >= 0)
+        actual[c + 1] = (primera[c] == 'S');
+    }
+    for (int fila = 0; fila + 1 < lineas.filas(); fila++)
+    {
+        const char *abajo = lineas.filaPtr(fila + 1);
+        u64 *m = mascara.data() + 1; // m[-1] i m[columnas] son el farciment
+        const u64 *a = actual.data() + 1;
+        u64 *s = siguiente.data() + 1;
+        for (int c = 0; c < columnas; c++)
         {
-            memo[fila][col] += posibilidades(lineas, fila + 1, col - 1, memo); // Esquerra
+            m[c] = -(u64)(abajo[c] == '^');
         }
-        if (col + 1 < lineas[fila].size())
+        for (int c = 0; c < columnas; c++)
         {
-            memo[fila][col] += posibilidades(lineas, fila + 1, col + 1, memo); // Dreta
+            s[c] = (a[c] & ~m[c]) + (a[c - 1] & m[c - 1]) + (a[c + 1] & m[c + 1]);
         }
+        actual.swap(siguiente);
     }
-    else
+    u64 total = 0;
+    for (u64 caminos : actual)
     {
-        memo[fila][col] += posibilidades(lineas, fila + 1, col, memo); // Segueix recte. Aso tambe se me havia olvidat ficar-ho y me donava sempre 0. Que dur.
+        total += caminos;
     }
-    return (memo[fila][col]);
+    return (ll)total;
 }
 
-int main(void)
+struct RejillaMemoria // Per al bench: la mateixa interficie que Rejilla pero generada en memoria
 {
-    vector<string> lineas;
-    string linea;
-    ifstream archivo("input.txt"); // Sempre igual
+    int nFilas, nColumnas;
+    vector<char> datos;
+    int filas() const { return nFilas; }
+    int columnas() const { return nColumnas; }
+    char at(int r, int c) const { return datos[(size_t)r * nColumnas + c]; }
+    const char *filaPtr(int r) const { return datos.data() + (size_t)r * nColumnas; }
+};
 
-    if (!archivo.is_open()) // Sempre igual
+int bench(int ancho, int filas)
+{
+    RejillaMemoria g{filas, ancho, vector<char>((size_t)filas * ancho, '.')};
+    mt19937 gen(2025);
+    for (int c = 0; c < ancho; c += 97) // Uns quants punts d'inici
     {
-        cerr << "Error al abrir el archivo." << endl;
-        return 1;
+        g.datos[c] = 'S';
     }
-    while (getline(archivo, linea)) // Sempre igual
+    for (size_t i = ancho; i < g.datos.size(); i++)
     {
-        lineas.push_back(linea);
+        if (gen() % 100 < 5)
+        {
+            g.datos[i] = '^';
+        }
     }
-    archivo.close();
 
-    ll totalPosibilidades = 0;                                            // long long perque sino se fica especialet y no retorna lo que toca
-    vector<vector<ll>> memo(lineas.size(), vector<ll>(lineas[0].size())); // Reutilitzat de altres problemes, sempre a ma
-    for (int i = 0; i < lineas[0].size(); i++)
+    auto t0 = chrono::steady_clock::now();
+    ll a = posibilidades(g);
+    auto t1 = chrono::steady_clock::now();
+    ll b = posibilidades_vectorial(g);
+    auto t2 = chrono::steady_clock::now();
+    cout << ancho << "x" << filas << ": escalar " << chrono::duration<double, milli>(t1 - t0).count() << " ms (" << a
+         << "), vectorial " << chrono::duration<double, milli>(t2 - t1).count() << " ms (" << b << ")" << endl;
+    return (a == b) ? 0 : 1;
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc >= 2 && strcmp(argv[1], "--bench") == 0) // --bench [ample] [files], per defecte 100000 x 1000
     {
-        if (lineas[0][i] == 'S') // Cuan trobe la columna de inici, comença tot
-        {
-            totalPosibilidades += posibilidades(lineas, 0, i, memo); // Ale a resar y que tot vatja be, perque ni jo se si ho fara o se ficara especialet
-        }
+        return bench(argc >= 3 ? atoi(argv[2]) : 100000, argc >= 4 ? atoi(argv[3]) : 1000);
     }
+
+    Rejilla lineas; // Mapejat en memoria, sense un string per fila
+    if (!lineas.abrir("input.txt"))
+    {
+        cerr << "Error al abrir el archivo." << endl;
+        return 1;
+    }
+
+    ll totalPosibilidades = (lineas.filas() > 0) ? posibilidades_vectorial(lineas) : 0; // long long perque sino se fica especialet y no retorna lo que toca
     cout << totalPosibilidades << endl; // Lo que ixga bo sera, confie
     return 0;
 }
\ No newline at end of file